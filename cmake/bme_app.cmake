@@ -0,0 +1,102 @@
+# Shared setup for the apps in this repo.
+#
+#   cmake_minimum_required(VERSION 3.20.0)
+#   include(${CMAKE_CURRENT_SOURCE_DIR}/../cmake/bme_app.cmake)
+#   bme_app_setup([LEDS <n>] [BUTTONS <n>] [OVERLAY <file>])
+#   find_package(Zephyr REQUIRED HINTS $ENV{ZEPHYR_BASE})
+#   project(my_app)
+#
+# Call it before find_package(Zephyr). On native_sim it turns OVERLAY
+# (default: boards/native_posix.overlay) into a native_sim overlay with
+# scripts/generate_overlay.py, padding the LED and button tables to LEDS and
+# BUTTONS entries (cache variables NATIVE_SIM_LEDS and NATIVE_SIM_BUTTONS).
+# The overlay is written to the build directory only when its content
+# changes, parsed overlays are cached in <build>/dts_cache, and the inputs
+# are configure dependencies, so editing the overlay re-runs the generator.
+#
+# On every board it also adds the code under common/ to the app target once
+# the app's CMakeLists.txt is done, each part behind its Kconfig option.
+
+get_filename_component(BME_ROOT ${CMAKE_CURRENT_LIST_DIR}/.. ABSOLUTE)
+
+function(bme_app_setup)
+  cmake_parse_arguments(ARG "" "LEDS;BUTTONS;OVERLAY" "" ${ARGN})
+
+  if(NOT DEFINED ARG_LEDS)
+    set(ARG_LEDS 0)
+  endif()
+  if(NOT DEFINED ARG_BUTTONS)
+    set(ARG_BUTTONS 0)
+  endif()
+  if(NOT DEFINED ARG_OVERLAY)
+    set(ARG_OVERLAY ${CMAKE_CURRENT_SOURCE_DIR}/boards/native_posix.overlay)
+  endif()
+
+  # target_sources() needs the app target, which find_package(Zephyr) creates
+  cmake_language(DEFER DIRECTORY ${CMAKE_CURRENT_SOURCE_DIR} CALL bme_app_common_sources)
+
+  if(NOT (DEFINED BOARD AND BOARD MATCHES "^native_sim"))
+    return()
+  endif()
+
+  message(STATUS "native_sim build detected - generating devicetree overlay")
+
+  find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+  set(NATIVE_SIM_LEDS ${ARG_LEDS} CACHE STRING "LEDs in the generated native_sim overlay")
+  set(NATIVE_SIM_BUTTONS ${ARG_BUTTONS} CACHE STRING "Buttons in the generated native_sim overlay")
+
+  # generated into the build directory so the source tree stays untouched
+  # and builds sharing a checkout don't race; the script only rewrites it
+  # when the content changes, which keeps the devicetree step quiet
+  set(overlay ${CMAKE_BINARY_DIR}/native_sim.overlay)
+
+  execute_process(
+    COMMAND
+      ${Python3_EXECUTABLE}
+      ${BME_ROOT}/scripts/generate_overlay.py
+      ${ARG_OVERLAY}
+      --output ${overlay}
+      --leds ${NATIVE_SIM_LEDS}
+      --buttons ${NATIVE_SIM_BUTTONS}
+      --cache-dir ${CMAKE_BINARY_DIR}/dts_cache
+    WORKING_DIRECTORY
+      ${CMAKE_CURRENT_SOURCE_DIR}
+    RESULT_VARIABLE result
+  )
+
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Failed to generate native_sim overlay")
+  endif()
+
+  # The devicetree is generated while CMake configures, so the overlay can't
+  # be a build step feeding it. Tracking the generator's inputs instead makes
+  # the build re-run this (incremental) configure step as soon as the
+  # overlay or the scripts change, rather than keeping a stale overlay.
+  set_property(DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS
+    ${ARG_OVERLAY}
+    ${BME_ROOT}/scripts/generate_overlay.py
+    ${BME_ROOT}/scripts/dts_parser.py
+  )
+
+  list(APPEND EXTRA_DTC_OVERLAY_FILE ${overlay})
+  set(EXTRA_DTC_OVERLAY_FILE ${EXTRA_DTC_OVERLAY_FILE} PARENT_SCOPE)
+endfunction()
+
+# code shared by every app in the repo
+function(bme_app_common_sources)
+  target_include_directories(app PRIVATE ${BME_ROOT}/common/include)
+  target_sources(app PRIVATE ${BME_ROOT}/common/src/app_exit.c)
+  target_sources_ifdef(CONFIG_APP_LOG_HEALTH app PRIVATE ${BME_ROOT}/common/src/log_health.c)
+
+  if(CONFIG_APP_GPIO_TRACE)
+    target_sources(app PRIVATE ${BME_ROOT}/common/src/gpio_trace.c)
+    # host half, built into the native simulator runner
+    target_sources(native_simulator INTERFACE ${BME_ROOT}/common/src/gpio_trace_bottom.c)
+  endif()
+
+  if(CONFIG_APP_STIMULUS)
+    target_sources(app PRIVATE ${BME_ROOT}/common/src/stimulus.c)
+    target_sources(native_simulator INTERFACE ${BME_ROOT}/common/src/stimulus_bottom.c)
+  endif()
+endfunction()
@@ -0,0 +1,12 @@
+#ifndef APP_EXIT_H
+#define APP_EXIT_H
+
+#include <stdbool.h>
+
+// Completion protocol: prints "RESULT PASS" or "RESULT FAIL" and, on
+// native_sim, terminates the simulation with exit code 0 or 1 once pending log
+// output has drained, so a harness never has to wait for a timeout. On real
+// hardware it returns and main() carries on as before.
+void app_finish(bool pass);
+
+#endif // APP_EXIT_H
@@ -0,0 +1,30 @@
+#ifndef GPIO_TRACE_H
+#define GPIO_TRACE_H
+
+#include <zephyr/device.h>
+#include <zephyr/sys/util.h>
+
+#if defined(CONFIG_APP_GPIO_TRACE)
+// Samples the pin levels of `port` and records them if they changed. Every
+// GPIO emulator labelled gpio0..gpio7 is traced; other ports are ignored.
+// Call after every write to an output and from input interrupt callbacks.
+// Safe from ISR context.
+void gpio_trace_sample(const struct device *port);
+
+// While paused, samples are ignored, e.g. to keep a benchmark's writes out
+// of both the trace and the timing. The first sample after resuming records
+// the levels the pins ended up at.
+void gpio_trace_pause(bool paused);
+#else
+static inline void gpio_trace_sample(const struct device *port)
+{
+    ARG_UNUSED(port);
+}
+
+static inline void gpio_trace_pause(bool paused)
+{
+    ARG_UNUSED(paused);
+}
+#endif
+
+#endif // GPIO_TRACE_H
@@ -0,0 +1,27 @@
+#ifndef LOG_HEALTH_H
+#define LOG_HEALTH_H
+
+#include <stdint.h>
+
+struct log_health {
+    uint32_t enqueued;   // processed + dropped + still pending
+    uint32_t processed;
+    uint32_t dropped;
+    uint32_t buf_size;   // deferred log buffer size in bytes
+    uint32_t hwm;        // most bytes ever in use in that buffer
+};
+
+// Waits (bounded) for pending messages to drain, then samples the counters.
+void log_health_get(struct log_health *health);
+
+// Prints the counters as one parseable line:
+//   LOG_HEALTH enqueued=<n> processed=<n> dropped=<n> buf_size=<bytes> hwm=<bytes>
+void log_health_report(void);
+
+// Finds the highest LOG_INF rate without drops and prints:
+//   LOG_BENCH max_rate=<msgs/s> mode=burst|sustained window_ms=<ms> buf_size=<bytes> hwm=<bytes>
+// mode=burst on native_sim without real-time pacing, where the result is the
+// burst one millisecond can absorb rather than a sustained rate.
+void log_health_bench(void);
+
+#endif // LOG_HEALTH_H
@@ -0,0 +1,27 @@
+#ifndef STIMULUS_H
+#define STIMULUS_H
+
+#include <stdbool.h>
+
+#if defined(CONFIG_APP_STIMULUS)
+// Starts replaying the file given with --stimulus, if any. Call once the
+// app has configured its inputs. Returns true if a replay was started.
+bool stimulus_start(void);
+
+// False once the replay has stopped on an error: unreadable file, malformed
+// line, unknown controller or an edge the emulator rejected. The error is
+// printed on a "STIMULUS error=" line.
+bool stimulus_ok(void);
+#else
+static inline bool stimulus_start(void)
+{
+    return false;
+}
+
+static inline bool stimulus_ok(void)
+{
+    return true;
+}
+#endif
+
+#endif // STIMULUS_H
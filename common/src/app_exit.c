@@ -0,0 +1,27 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log_ctrl.h>
+
+#if defined(CONFIG_ARCH_POSIX)
+#include "posix_board_if.h"
+#endif
+
+#include "app_exit.h"
+
+// how long to wait for the deferred log thread before exiting anyway
+#define LOG_DRAIN_TIMEOUT_MS 1000
+
+void app_finish(bool pass)
+{
+    printk("RESULT %s\n", pass ? "PASS" : "FAIL");
+
+#if defined(CONFIG_LOG) && !defined(CONFIG_LOG_MODE_MINIMAL)
+    for (int ms = 0; ms < LOG_DRAIN_TIMEOUT_MS && log_data_pending(); ms++) {
+        k_msleep(1);
+    }
+#endif
+
+#if defined(CONFIG_ARCH_POSIX)
+    posix_exit(pass ? 0 : 1);
+#endif
+}
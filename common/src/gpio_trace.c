@@ -0,0 +1,114 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/init.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include <posix_native_task.h>
+
+#include "gpio_trace.h"
+#include "gpio_trace_bottom.h"
+
+// gpio0..gpio7, where that node label is an enabled GPIO emulator; the
+// same numbering as the stimulus file's controllers
+#define CONTROLLER(i, _)                                                          \
+    COND_CODE_1(DT_NODE_HAS_COMPAT_STATUS(DT_NODELABEL(gpio##i), zephyr_gpio_emul, okay), \
+                (DEVICE_DT_GET(DT_NODELABEL(gpio##i))), (NULL))
+
+static const struct device *const controllers[GPIO_TRACE_PORTS] = {
+    LISTIFY(GPIO_TRACE_PORTS, CONTROLLER, (,))
+};
+
+static struct gpio_trace_entry entries[CONFIG_APP_GPIO_TRACE_ENTRIES];
+static uint32_t count;
+static uint32_t dropped;
+static uint32_t initial_levels[GPIO_TRACE_PORTS];
+static uint32_t last_levels[GPIO_TRACE_PORTS];
+static bool trace_paused;
+static struct k_spinlock trace_lock;
+
+static uint32_t port_levels(const struct device *port)
+{
+    gpio_port_value_t outputs = 0;
+    gpio_port_value_t inputs = 0;
+
+    // the emulator reports output and input pins separately, each masked to
+    // pins configured that way, so the two never overlap
+    gpio_emul_output_get_masked(port, UINT32_MAX, &outputs);
+    gpio_port_get_raw(port, &inputs);
+
+    return outputs | inputs;
+}
+
+void gpio_trace_sample(const struct device *port)
+{
+    uint32_t p = 0;
+
+    if (trace_paused) {
+        return;
+    }
+
+    while (p < GPIO_TRACE_PORTS && controllers[p] != port) {
+        p++;
+    }
+    if (p == GPIO_TRACE_PORTS) {
+        return;
+    }
+
+    uint32_t levels = port_levels(port);
+    uint64_t t_ns = k_cyc_to_ns_near64(k_cycle_get_64());
+    k_spinlock_key_t key = k_spin_lock(&trace_lock);
+
+    if (levels != last_levels[p]) {
+        if (count < ARRAY_SIZE(entries)) {
+            entries[count++] = (struct gpio_trace_entry){
+                .t_ns = t_ns,
+                .levels = levels,
+                .changed = levels ^ last_levels[p],
+                .port = p,
+            };
+        } else {
+            dropped++;
+        }
+        last_levels[p] = levels;
+    }
+
+    k_spin_unlock(&trace_lock, key);
+}
+
+void gpio_trace_pause(bool paused)
+{
+    trace_paused = paused;
+}
+
+// the levels every trace starts from, before the app touches a pin
+static int gpio_trace_init(void)
+{
+    for (uint32_t p = 0; p < GPIO_TRACE_PORTS; p++) {
+        if (controllers[p] != NULL) {
+            initial_levels[p] = port_levels(controllers[p]);
+            last_levels[p] = initial_levels[p];
+        }
+    }
+    return 0;
+}
+
+SYS_INIT(gpio_trace_init, APPLICATION, 0);
+
+static void gpio_trace_flush(void)
+{
+    int err = gpio_trace_bottom_write(CONFIG_APP_GPIO_TRACE_FILE, entries, count,
+                                      initial_levels, dropped);
+
+    if (err < 0) {
+        printk("GPIO_TRACE write to %s failed (%d)\n", CONFIG_APP_GPIO_TRACE_FILE, err);
+        return;
+    }
+
+    printk("GPIO_TRACE file=%s entries=%u dropped=%u\n", CONFIG_APP_GPIO_TRACE_FILE, count, dropped);
+}
+
+NATIVE_TASK(gpio_trace_flush, ON_EXIT, 10);
@@ -0,0 +1,116 @@
+// Host half of the gpio trace recorder, built into the native simulator
+// runner (see gpio_trace_bottom.h).
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "gpio_trace_bottom.h"
+
+#define PINS 32
+
+static int write_bin(const char *path, const struct gpio_trace_entry *entries,
+                     uint64_t count, const uint32_t *initial_levels, uint32_t dropped)
+{
+    FILE *f = fopen(path, "wb");
+    uint32_t version = GPIO_TRACE_VERSION;
+    uint32_t ports = GPIO_TRACE_PORTS;
+
+    if (f == NULL) {
+        return -errno;
+    }
+
+    // native_sim hosts are little-endian, so the structs are written as is
+    fwrite(GPIO_TRACE_MAGIC, 1, 4, f);
+    fwrite(&version, sizeof(version), 1, f);
+    fwrite(&count, sizeof(count), 1, f);
+    fwrite(&dropped, sizeof(dropped), 1, f);
+    fwrite(&ports, sizeof(ports), 1, f);
+    fwrite(initial_levels, sizeof(*initial_levels), GPIO_TRACE_PORTS, f);
+    fwrite(entries, sizeof(*entries), count, f);
+
+    return fclose(f) == 0 ? 0 : -errno;
+}
+
+// VCD identifiers are printable characters, two of them cover every pin of
+// every port
+static const char *vcd_id(uint32_t port, int pin)
+{
+    static char id[3];
+    uint32_t n = port * PINS + pin;
+
+    id[0] = (char)('!' + n % 94);
+    id[1] = (char)('!' + n / 94);
+    return id;
+}
+
+static int write_vcd(const char *path, const struct gpio_trace_entry *entries,
+                     uint64_t count, const uint32_t *initial_levels)
+{
+    FILE *f = fopen(path, "w");
+    uint32_t used[GPIO_TRACE_PORTS] = {0};
+
+    if (f == NULL) {
+        return -errno;
+    }
+
+    // only declare pins that ever move
+    for (uint64_t i = 0; i < count; i++) {
+        used[entries[i].port] |= entries[i].changed;
+    }
+
+    fprintf(f, "$comment gpio transitions recorded on native_sim $end\n");
+    fprintf(f, "$timescale 1ns $end\n");
+    for (uint32_t port = 0; port < GPIO_TRACE_PORTS; port++) {
+        if (used[port] == 0) {
+            continue;
+        }
+        fprintf(f, "$scope module gpio%u $end\n", port);
+        for (int pin = 0; pin < PINS; pin++) {
+            if (used[port] & (1U << pin)) {
+                fprintf(f, "$var wire 1 %s pin%d $end\n", vcd_id(port, pin), pin);
+            }
+        }
+        fprintf(f, "$upscope $end\n");
+    }
+    fprintf(f, "$enddefinitions $end\n");
+
+    fprintf(f, "#0\n$dumpvars\n");
+    for (uint32_t port = 0; port < GPIO_TRACE_PORTS; port++) {
+        for (int pin = 0; pin < PINS; pin++) {
+            if (used[port] & (1U << pin)) {
+                fprintf(f, "%d%s\n", (initial_levels[port] >> pin) & 1, vcd_id(port, pin));
+            }
+        }
+    }
+    fprintf(f, "$end\n");
+
+    for (uint64_t i = 0; i < count; i++) {
+        fprintf(f, "#%llu\n", (unsigned long long)entries[i].t_ns);
+        for (int pin = 0; pin < PINS; pin++) {
+            if (entries[i].changed & (1U << pin)) {
+                fprintf(f, "%d%s\n", (entries[i].levels >> pin) & 1,
+                        vcd_id(entries[i].port, pin));
+            }
+        }
+    }
+
+    return fclose(f) == 0 ? 0 : -errno;
+}
+
+int gpio_trace_bottom_write(const char *base, const struct gpio_trace_entry *entries,
+                            uint64_t count, const uint32_t *initial_levels,
+                            uint32_t dropped)
+{
+    char path[512];
+    int err;
+
+    snprintf(path, sizeof(path), "%s.bin", base);
+    err = write_bin(path, entries, count, initial_levels, dropped);
+    if (err < 0) {
+        return err;
+    }
+
+    snprintf(path, sizeof(path), "%s.vcd", base);
+    return write_vcd(path, entries, count, initial_levels);
+}
@@ -0,0 +1,37 @@
+#ifndef GPIO_TRACE_BOTTOM_H
+#define GPIO_TRACE_BOTTOM_H
+
+// Interface between the embedded (gpio_trace.c) and host (gpio_trace_bottom.c)
+// halves of the trace recorder. The host half runs in the native simulator
+// runner with the host C library, so only plain C types cross it.
+
+#include <stdint.h>
+
+// controllers gpio0..gpio<GPIO_TRACE_PORTS - 1> are traced
+#define GPIO_TRACE_PORTS 8
+
+// One recorded transition. The binary trace is a header followed by these,
+// little-endian:
+//   header: char magic[4] = "GTRC", uint32 version, uint64 count,
+//           uint32 dropped, uint32 ports,
+//           uint32 initial_levels[ports] (pin levels of gpio<n> at start)
+//   entry:  uint64 t_ns, uint32 levels, uint32 changed, uint32 port,
+//           uint32 reserved
+struct gpio_trace_entry {
+    uint64_t t_ns;     // simulated time of the transition
+    uint32_t levels;   // pin levels of the port after it
+    uint32_t changed;  // pins that changed
+    uint32_t port;     // n of gpio<n>
+    uint32_t reserved;
+};
+
+#define GPIO_TRACE_MAGIC "GTRC"
+#define GPIO_TRACE_VERSION 2
+
+// Writes <base>.bin and <base>.vcd. `initial_levels` has GPIO_TRACE_PORTS
+// entries. Returns 0 or a negative errno.
+int gpio_trace_bottom_write(const char *base, const struct gpio_trace_entry *entries,
+                            uint64_t count, const uint32_t *initial_levels,
+                            uint32_t dropped);
+
+#endif // GPIO_TRACE_BOTTOM_H
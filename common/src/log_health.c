@@ -0,0 +1,168 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/logging/log_backend.h>
+#include <zephyr/logging/log_ctrl.h>
+
+#include "log_health.h"
+
+LOG_MODULE_REGISTER(log_health, LOG_LEVEL_INF);
+
+// how long log_health_get() waits for the log thread to catch up
+#define DRAIN_TIMEOUT_MS 1000
+
+static atomic_t processed;
+static atomic_t dropped;
+
+// Backend that outputs nothing and only counts what the log core hands it.
+static void health_process(const struct log_backend *const backend, union log_msg_generic *msg)
+{
+    ARG_UNUSED(backend);
+    ARG_UNUSED(msg);
+    atomic_inc(&processed);
+}
+
+static void health_dropped(const struct log_backend *const backend, uint32_t cnt)
+{
+    ARG_UNUSED(backend);
+    atomic_add(&dropped, cnt);
+}
+
+static void health_panic(const struct log_backend *const backend)
+{
+    ARG_UNUSED(backend);
+}
+
+static const struct log_backend_api log_health_api = {
+    .process = health_process,
+    .dropped = health_dropped,
+    .panic = health_panic,
+};
+
+LOG_BACKEND_DEFINE(log_health_backend, log_health_api, true);
+
+static void drain(void)
+{
+    for (int ms = 0; ms < DRAIN_TIMEOUT_MS && log_data_pending(); ms++) {
+        k_msleep(1);
+    }
+}
+
+void log_health_get(struct log_health *health)
+{
+    drain();
+
+    health->processed = (uint32_t)atomic_get(&processed);
+    health->dropped = (uint32_t)atomic_get(&dropped);
+    health->enqueued = health->processed + health->dropped + log_buffered_cnt();
+
+    uint32_t usage;
+
+    if (log_mem_get_usage(&health->buf_size, &usage) != 0 ||
+        log_mem_get_max_usage(&health->hwm) != 0) {
+        health->buf_size = 0;
+        health->hwm = 0;
+    }
+}
+
+void log_health_report(void)
+{
+    struct log_health health;
+
+    log_health_get(&health);
+
+    printk("LOG_HEALTH enqueued=%u processed=%u dropped=%u buf_size=%u hwm=%u\n",
+           health.enqueued, health.processed, health.dropped, health.buf_size, health.hwm);
+}
+
+#if defined(CONFIG_APP_LOG_BENCH)
+
+// On native_sim without real-time pacing, simulated time stands still while
+// the log thread formats and outputs messages, so each 1 ms slice's messages
+// are drained before the next slice starts. The benchmark then finds the
+// largest burst the buffer absorbs per slice, not a rate the host could keep
+// up in wall-clock time, and says so on its output line.
+#if defined(CONFIG_ARCH_POSIX) && !defined(CONFIG_NATIVE_SIM_SLOWDOWN_TO_REAL_TIME)
+#define BENCH_MODE "burst"
+#else
+#define BENCH_MODE "sustained"
+#endif
+
+// Emits `rate` messages per second for the bench window and reports whether
+// any of them were dropped. The messages due by the end of each millisecond
+// are rate * elapsed / 1000, so fractional rates (1500/s, 300/s, ...) are
+// spread over the window without rounding and exactly the reported rate is
+// emitted.
+static bool rate_drops(uint32_t rate)
+{
+    uint32_t before;
+    uint32_t seq = 0;
+
+    drain();
+    before = (uint32_t)atomic_get(&dropped);
+
+    int64_t start = k_uptime_get();
+
+    for (uint32_t ms = 1; ms <= CONFIG_APP_LOG_BENCH_WINDOW_MS; ms++) {
+        uint32_t due = (uint32_t)((uint64_t)rate * ms / MSEC_PER_SEC);
+
+        while (seq < due) {
+            LOG_INF("log bench rate=%u seq=%u", rate, seq++);
+        }
+        // absolute deadlines, so the time spent logging does not add up
+        k_sleep(K_TIMEOUT_ABS_MS(start + ms));
+    }
+
+    drain();
+    return (uint32_t)atomic_get(&dropped) != before;
+}
+
+void log_health_bench(void)
+{
+    uint32_t rate = CONFIG_APP_LOG_BENCH_START_RATE;
+    uint32_t good = 0;
+    uint32_t bad = 0;
+
+    if (rate_drops(rate)) {
+        // halve until a clean rate is found below the start...
+        bad = rate;
+        for (rate /= 2U; rate > 0; rate /= 2U) {
+            if (!rate_drops(rate)) {
+                good = rate;
+                break;
+            }
+            bad = rate;
+        }
+    } else {
+        // ...or double until the first rate that drops
+        good = rate;
+        for (rate *= 2U; rate <= CONFIG_APP_LOG_BENCH_MAX_RATE; rate *= 2U) {
+            if (rate_drops(rate)) {
+                bad = rate;
+                break;
+            }
+            good = rate;
+        }
+    }
+
+    // then bisect between the last clean rate and the first that dropped
+    while (bad != 0 && good != 0 && bad - good > good / 16U) {
+        uint32_t mid = good + (bad - good) / 2U;
+
+        if (rate_drops(mid)) {
+            bad = mid;
+        } else {
+            good = mid;
+        }
+    }
+
+    struct log_health health;
+
+    log_health_get(&health);
+
+    printk("LOG_BENCH max_rate=%u mode=%s window_ms=%u buf_size=%u hwm=%u\n",
+           good, BENCH_MODE, CONFIG_APP_LOG_BENCH_WINDOW_MS, health.buf_size, health.hwm);
+}
+
+#endif // CONFIG_APP_LOG_BENCH
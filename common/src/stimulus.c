@@ -0,0 +1,135 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/sys/util.h>
+
+#include <posix_native_task.h>
+#include "cmdline.h"
+
+#include "stimulus.h"
+#include "stimulus_bottom.h"
+
+// gpio0..gpio7, where that node label is an enabled GPIO emulator
+#define MAX_CONTROLLERS 8
+
+#define CONTROLLER(i, _)                                                          \
+    COND_CODE_1(DT_NODE_HAS_COMPAT_STATUS(DT_NODELABEL(gpio##i), zephyr_gpio_emul, okay), \
+                (DEVICE_DT_GET(DT_NODELABEL(gpio##i))), (NULL))
+
+static const struct device *const controllers[MAX_CONTROLLERS] = {
+    LISTIFY(MAX_CONTROLLERS, CONTROLLER, (,))
+};
+
+static void stimulus_expiry(struct k_timer *timer);
+
+K_TIMER_DEFINE(stimulus_timer, stimulus_expiry, NULL);
+
+static char *stim_path;
+static struct stimulus_edge next_edge;
+static uint32_t next_line;       // file line next_edge was read from
+static uint32_t edges;
+static bool failed;
+
+static struct args_struct_t stimulus_args[] = {
+    {
+        .option = "stimulus",
+        .name = "file",
+        .type = 's',
+        .dest = (void *)&stim_path,
+        .descript = "Replay timestamped GPIO input edges from <file> on the simulated clock",
+    },
+    ARG_TABLE_ENDMARKER
+};
+
+static void stimulus_register_args(void)
+{
+    native_add_command_line_opts(stimulus_args);
+}
+
+NATIVE_TASK(stimulus_register_args, PRE_BOOT_1, 10);
+
+static void stimulus_finish(int err, uint32_t line)
+{
+    stimulus_bottom_close();
+
+    if (err < 0) {
+        failed = true;
+        printk("STIMULUS error=%d file=%s line=%u edges=%u\n", err, stim_path, line, edges);
+    } else {
+        printk("STIMULUS file=%s edges=%u\n", stim_path, edges);
+    }
+}
+
+// Reads and validates the next edge. Returns false when the replay is over.
+static bool stimulus_fetch(void)
+{
+    int ret = stimulus_bottom_next(&next_edge, &next_line);
+
+    if (ret <= 0) {
+        stimulus_finish(ret, next_line);
+        return false;
+    }
+
+    if (next_edge.ctrl >= MAX_CONTROLLERS || controllers[next_edge.ctrl] == NULL) {
+        stimulus_finish(-ENODEV, next_line);
+        return false;
+    }
+
+    return true;
+}
+
+static void stimulus_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    // runs in ISR context, like a real input edge; the emulator calls the
+    // GPIO callbacks synchronously. Edges sharing a timestamp are applied
+    // back to back.
+    do {
+        int err = gpio_emul_input_set(controllers[next_edge.ctrl], next_edge.pin,
+                                      next_edge.level);
+
+        // e.g. a pin that is not configured as an input
+        if (err < 0) {
+            printk("STIMULUS gpio%u pin %u rejected level %u\n",
+                   next_edge.ctrl, next_edge.pin, next_edge.level);
+            stimulus_finish(err, next_line);
+            return;
+        }
+        edges++;
+
+        if (!stimulus_fetch()) {
+            return;
+        }
+    } while (next_edge.t_us <= k_ticks_to_us_floor64(k_uptime_ticks()));
+
+    k_timer_start(&stimulus_timer, K_TIMEOUT_ABS_US(next_edge.t_us), K_NO_WAIT);
+}
+
+bool stimulus_start(void)
+{
+    if (stim_path == NULL) {
+        return false;
+    }
+
+    int err = stimulus_bottom_open(stim_path);
+
+    if (err < 0) {
+        stimulus_finish(err, 0);
+        return false;
+    }
+
+    if (!stimulus_fetch()) {
+        return false;
+    }
+
+    k_timer_start(&stimulus_timer, K_TIMEOUT_ABS_US(next_edge.t_us), K_NO_WAIT);
+    return true;
+}
+
+bool stimulus_ok(void)
+{
+    return !failed;
+}
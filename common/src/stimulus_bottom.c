@@ -0,0 +1,87 @@
+// Host half of the stimulus replay, built into the native simulator runner
+// (see stimulus_bottom.h).
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "stimulus_bottom.h"
+
+static FILE *stim_file;
+static uint32_t stim_line;
+static uint64_t stim_last_us;
+
+int stimulus_bottom_open(const char *path)
+{
+    stim_file = fopen(path, "r");
+    if (stim_file == NULL) {
+        return -errno;
+    }
+
+    stim_line = 0;
+    stim_last_us = 0;
+    return 0;
+}
+
+int stimulus_bottom_next(struct stimulus_edge *edge, uint32_t *line)
+{
+    char buf[256];
+
+    if (stim_file == NULL) {
+        return 0;
+    }
+
+    while (fgets(buf, sizeof(buf), stim_file) != NULL) {
+        char *p = buf;
+        int relative = 0;
+        uint64_t t_us;
+        uint32_t ctrl, pin, level;
+        char extra;
+
+        stim_line++;
+        *line = stim_line;
+
+        char *comment = strchr(p, '#');
+        if (comment != NULL) {
+            *comment = '\0';
+        }
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        if (*p == '\0' || *p == '\n' || *p == '\r') {
+            continue;
+        }
+        if (*p == '+') {
+            relative = 1;
+            p++;
+        }
+
+        if (sscanf(p, "%" SCNu64 " %" SCNu32 " %" SCNu32 " %" SCNu32 " %c",
+                   &t_us, &ctrl, &pin, &level, &extra) != 4 || level > 1) {
+            return -EINVAL;
+        }
+        if (relative) {
+            t_us += stim_last_us;
+        } else if (t_us < stim_last_us) {
+            return -EINVAL;  // absolute times must not go backwards
+        }
+
+        stim_last_us = t_us;
+        edge->t_us = t_us;
+        edge->ctrl = ctrl;
+        edge->pin = pin;
+        edge->level = level;
+        return 1;
+    }
+
+    return 0;
+}
+
+void stimulus_bottom_close(void)
+{
+    if (stim_file != NULL) {
+        fclose(stim_file);
+        stim_file = NULL;
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef STIMULUS_BOTTOM_H
+#define STIMULUS_BOTTOM_H
+
+// Interface between the embedded (stimulus.c) and host (stimulus_bottom.c)
+// halves of the stimulus replay. The host half reads the file with the host C
+// library in the native simulator runner, so only plain C types cross it.
+
+#include <stdint.h>
+
+struct stimulus_edge {
+    uint64_t t_us;     // absolute simulated time
+    uint32_t ctrl;     // gpio<N> controller
+    uint32_t pin;
+    uint32_t level;    // physical level, 0 or 1
+};
+
+// Returns 0 or a negative errno.
+int stimulus_bottom_open(const char *path);
+
+// Reads the next edge. Returns 1 when one was read, 0 at the end of the file
+// and a negative errno on a malformed line, whose number is left in *line.
+int stimulus_bottom_next(struct stimulus_edge *edge, uint32_t *line);
+
+void stimulus_bottom_close(void);
+
+#endif // STIMULUS_BOTTOM_H
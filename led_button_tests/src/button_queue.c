@@ -0,0 +1,59 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/util.h>
+
+#include "button_queue.h"
+
+#define QUEUE_SIZE CONFIG_APP_BUTTON_QUEUE_SIZE
+#define QUEUE_MASK (QUEUE_SIZE - 1)
+
+BUILD_ASSERT(IS_POWER_OF_TWO(QUEUE_SIZE), "CONFIG_APP_BUTTON_QUEUE_SIZE must be a power of two");
+
+static struct button_event queue[QUEUE_SIZE];
+
+// Free running indices: head is only written by the producer, tail only by
+// the consumer. The atomic accessors are sequentially consistent, which keeps
+// the record store ordered before the index that publishes it.
+static atomic_t queue_head;
+static atomic_t queue_tail;
+static atomic_t queue_dropped;
+
+// counts published records so the consumer can sleep instead of polling
+K_SEM_DEFINE(queue_sem, 0, QUEUE_SIZE);
+
+bool button_queue_put(const struct button_event *evt)
+{
+    atomic_val_t head = atomic_get(&queue_head);
+
+    if ((uint32_t)(head - atomic_get(&queue_tail)) >= QUEUE_SIZE) {
+        atomic_inc(&queue_dropped);
+        return false;
+    }
+
+    queue[head & QUEUE_MASK] = *evt;
+    atomic_set(&queue_head, head + 1);
+    k_sem_give(&queue_sem);
+
+    return true;
+}
+
+int button_queue_get(struct button_event *evt, k_timeout_t timeout)
+{
+    int ret = k_sem_take(&queue_sem, timeout);
+
+    if (ret != 0) {
+        return ret;
+    }
+
+    atomic_val_t tail = atomic_get(&queue_tail);
+
+    *evt = queue[tail & QUEUE_MASK];
+    atomic_set(&queue_tail, tail + 1);
+
+    return 0;
+}
+
+uint32_t button_queue_dropped(void)
+{
+    return (uint32_t)atomic_get(&queue_dropped);
+}
@@ -0,0 +1,43 @@
+#ifndef BUTTON_QUEUE_H
+#define BUTTON_QUEUE_H
+
+#include <zephyr/kernel.h>
+
+#define BUTTON_EDGE_RELEASE 0
+#define BUTTON_EDGE_PRESS 1
+
+struct button_event {
+    uint64_t cycles;           // hardware cycles at the interrupt of the first edge
+    uint64_t accepted_cycles;  // hardware cycles when the debouncer accepted it
+    uint32_t pins;    // pin mask handed to the GPIO callback
+    uint8_t edge;     // BUTTON_EDGE_PRESS or BUTTON_EDGE_RELEASE
+};
+
+// Cycle counter used for button timestamps, 64-bit where the timer has one.
+static inline uint64_t button_cycles(void)
+{
+    if (IS_ENABLED(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)) {
+        return k_cycle_get_64();
+    }
+    return k_cycle_get_32();
+}
+
+// Cycles from `from` to `to`, both read with button_cycles(). With only a
+// 32-bit counter the difference is taken modulo 2^32, so it stays right
+// across one wrap of the counter.
+static inline uint64_t button_cycles_between(uint64_t from, uint64_t to)
+{
+    if (IS_ENABLED(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)) {
+        return to - from;
+    }
+    return (uint32_t)((uint32_t)to - (uint32_t)from);
+}
+
+// Single producer (the debounce stage) / single consumer (main) ring buffer.
+// Every edge gets its own record, so presses are never merged; if the ring is
+// full the record is dropped and counted instead of blocking the producer.
+bool button_queue_put(const struct button_event *evt);
+int button_queue_get(struct button_event *evt, k_timeout_t timeout);
+uint32_t button_queue_dropped(void);
+
+#endif // BUTTON_QUEUE_H
@@ -0,0 +1,115 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+#include <zephyr/drivers/gpio.h>
+
+#include "button_queue.h"
+#include "debounce.h"
+
+static void settle_handler(struct k_work *work);
+
+K_WORK_DELAYABLE_DEFINE(settle_work, settle_handler);
+
+static const struct gpio_dt_spec *db_button;
+static uint64_t window_cycles;
+
+// written by the ISR only
+static uint64_t burst_start_cycles;  // first edge of the current burst
+static uint32_t edges;
+static uint32_t suppressed;          // edges dropped inside a burst's window
+
+// owned by the settle work (the ISR, with no window)
+static int stable_level;
+static uint32_t bounced;             // bursts that settled where they started
+static uint32_t accepted;
+static uint32_t queue_full;          // accepted levels the queue had no room for
+
+static void queue_level(uint64_t cycles, uint64_t accepted_cycles, uint32_t pins, int level)
+{
+    struct button_event evt = {
+        .cycles = cycles,
+        .accepted_cycles = accepted_cycles,
+        .pins = pins,
+        .edge = level > 0 ? BUTTON_EDGE_PRESS : BUTTON_EDGE_RELEASE,
+    };
+
+    if (button_queue_put(&evt)) {
+        accepted++;
+    } else {
+        queue_full++;
+    }
+}
+
+// Samples the line once the window opened by the first edge of a burst has
+// passed. The event carries both the interrupt timestamp of that first edge
+// and the time it is accepted here.
+static void settle_handler(struct k_work *work)
+{
+    ARG_UNUSED(work);
+
+    uint64_t accepted_cycles = button_cycles();
+    unsigned int key = irq_lock();
+    uint64_t cycles = burst_start_cycles;
+
+    irq_unlock(key);
+
+    int level = gpio_pin_get_dt(db_button);
+
+    if (level < 0) {
+        return;
+    }
+    if (level == stable_level) {
+        bounced++;
+        return;
+    }
+
+    stable_level = level;
+    queue_level(cycles, accepted_cycles, BIT(db_button->pin), level);
+}
+
+int debounce_init(const struct gpio_dt_spec *button)
+{
+    db_button = button;
+    window_cycles = (uint64_t)CONFIG_APP_DEBOUNCE_MS * sys_clock_hw_cycles_per_sec() / 1000U;
+
+    stable_level = gpio_pin_get_dt(button);
+    if (stable_level < 0) {
+        return stable_level;
+    }
+
+    return 0;
+}
+
+void debounce_edge(uint32_t pins)
+{
+    uint64_t now = button_cycles();
+
+    edges++;
+
+    if (window_cycles == 0) {
+        int level = gpio_pin_get_dt(db_button);
+
+        if (level >= 0) {
+            queue_level(now, now, pins, level);
+        }
+        return;
+    }
+
+    // An edge within the window of the one that opened the current burst is
+    // bounce: it is dropped here by its timestamp and never touches the work
+    // queue. The first edge after the window opens a new burst and moves the
+    // sample of the line to the end of that burst's window.
+    if (edges > 1 && button_cycles_between(burst_start_cycles, now) < window_cycles) {
+        suppressed++;
+        return;
+    }
+
+    burst_start_cycles = now;
+    k_work_reschedule(&settle_work, K_MSEC(CONFIG_APP_DEBOUNCE_MS));
+}
+
+void debounce_report(void)
+{
+    printk("DEBOUNCE window_ms=%u edges=%u suppressed=%u bounced=%u accepted=%u "
+           "queue_full=%u\n",
+           CONFIG_APP_DEBOUNCE_MS, edges, suppressed, bounced, accepted, queue_full);
+}
@@ -0,0 +1,19 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <zephyr/drivers/gpio.h>
+
+// Debounce stage between the button interrupt and the event queue.
+int debounce_init(const struct gpio_dt_spec *button);
+
+// Called from the GPIO callback for every edge (both directions).
+void debounce_edge(uint32_t pins);
+
+// Prints the debounce counters as one parseable line:
+//   DEBOUNCE window_ms=<ms> edges=<n> suppressed=<n> bounced=<n> accepted=<n> queue_full=<n>
+// suppressed: edges dropped by timestamp inside a burst's window
+// bounced: bursts whose line settled back at the level it started from
+// queue_full: settled levels lost because the event queue was full
+void debounce_report(void);
+
+#endif // DEBOUNCE_H
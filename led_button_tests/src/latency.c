@@ -0,0 +1,98 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "latency.h"
+
+// the last bucket collects everything beyond the range, so with a single
+// bucket every percentile would report the same value
+BUILD_ASSERT(CONFIG_APP_LATENCY_BUCKETS >= 2 && CONFIG_APP_ACCEPT_LATENCY_BUCKETS >= 2,
+             "p50 and p99 need at least two histogram buckets");
+
+// interrupt-to-LED samples include the debounce window, so the histogram
+// has to reach past it or every percentile lands in the overflow bucket
+BUILD_ASSERT((uint64_t)CONFIG_APP_LATENCY_BUCKET_US * CONFIG_APP_LATENCY_BUCKETS >
+             (uint64_t)CONFIG_APP_DEBOUNCE_MS * USEC_PER_MSEC,
+             "the interrupt-to-LED histogram must cover CONFIG_APP_DEBOUNCE_MS");
+
+struct histogram {
+    const char *name;
+    uint32_t bucket_ns;
+    uint32_t count;
+    uint32_t *buckets;
+    uint32_t samples;
+    uint32_t overflow;
+    uint32_t min_ns;
+    uint32_t max_ns;
+};
+
+#define HISTOGRAM(_name, _bucket_us, _count)                  \
+    {                                                         \
+        .name = _name,                                        \
+        .bucket_ns = (_bucket_us) * NSEC_PER_USEC,            \
+        .count = (_count),                                    \
+        .buckets = (uint32_t[_count]){ 0 },                   \
+        .min_ns = UINT32_MAX,                                 \
+    }
+
+static struct histogram irq_to_led =
+    HISTOGRAM("LATENCY_NS", CONFIG_APP_LATENCY_BUCKET_US, CONFIG_APP_LATENCY_BUCKETS);
+static struct histogram accept_to_led =
+    HISTOGRAM("ACCEPT_LATENCY_NS", CONFIG_APP_ACCEPT_LATENCY_BUCKET_US,
+              CONFIG_APP_ACCEPT_LATENCY_BUCKETS);
+
+static void record(struct histogram *h, uint64_t cycles)
+{
+    uint64_t ns64 = k_cyc_to_ns_near64(cycles);
+    uint32_t ns = ns64 > UINT32_MAX ? UINT32_MAX : (uint32_t)ns64;
+    uint32_t bucket = MIN(ns / h->bucket_ns, h->count - 1);
+
+    if ((uint64_t)ns >= (uint64_t)h->bucket_ns * h->count) {
+        h->overflow++;
+    }
+    h->buckets[bucket]++;
+    h->samples++;
+    h->min_ns = MIN(h->min_ns, ns);
+    h->max_ns = MAX(h->max_ns, ns);
+}
+
+void latency_record(uint64_t irq_cycles, uint64_t accept_cycles)
+{
+    record(&irq_to_led, irq_cycles);
+    record(&accept_to_led, accept_cycles);
+}
+
+// Upper edge of the bucket holding the given percentile, clamped to the
+// observed range so a single sample reports its exact value.
+static uint32_t percentile(const struct histogram *h, uint32_t pct)
+{
+    uint32_t rank = DIV_ROUND_UP(h->samples * pct, 100U);
+    uint32_t seen = 0;
+
+    for (uint32_t i = 0; i < h->count; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            return (uint32_t)CLAMP((uint64_t)(i + 1) * h->bucket_ns, h->min_ns, h->max_ns);
+        }
+    }
+    return h->max_ns;
+}
+
+static void report(const struct histogram *h)
+{
+    if (h->samples == 0) {
+        printk("%s samples=0\n", h->name);
+        return;
+    }
+
+    // percentiles falling into the overflow bucket are clamped to max, a
+    // non-zero overflow count means the histogram range is too small
+    printk("%s samples=%u min=%u p50=%u p99=%u max=%u overflow=%u\n",
+           h->name, h->samples, h->min_ns, percentile(h, 50), percentile(h, 99), h->max_ns,
+           h->overflow);
+}
+
+void latency_report(void)
+{
+    report(&irq_to_led);
+    report(&accept_to_led);
+}
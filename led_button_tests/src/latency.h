@@ -0,0 +1,20 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <zephyr/kernel.h>
+
+// Records one press, both spans ending at the LED write and given in
+// hardware cycles:
+//   irq_cycles     from the GPIO interrupt of the press's first edge, the
+//                  debounce window included
+//   accept_cycles  from the debouncer accepting the press
+void latency_record(uint64_t irq_cycles, uint64_t accept_cycles);
+
+// Prints min/p50/p99/max of both spans as parseable lines:
+//   LATENCY_NS samples=<n> min=<ns> p50=<ns> p99=<ns> max=<ns> overflow=<n>
+//   ACCEPT_LATENCY_NS samples=<n> min=<ns> p50=<ns> p99=<ns> max=<ns> overflow=<n>
+// LATENCY_NS is interrupt-to-LED, ACCEPT_LATENCY_NS acceptance-to-LED;
+// overflow counts the samples beyond the histogram range.
+void latency_report(void);
+
+#endif // LATENCY_H
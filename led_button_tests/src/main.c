@@ -13,6 +13,15 @@
 #include <zephyr/logging/log.h>
 // #include <zephyr/drivers/adc/adc_emul.h>
 
+#include "button_queue.h"
+#include "debounce.h"
+#include "latency.h"
+
+#include "gpio_trace.h"
+#include "app_exit.h"
+#include "log_health.h"
+#include "stimulus.h"
+
 LOG_MODULE_REGISTER(main, LOG_LEVEL_DBG);
 
 #define LED_ON 1
@@ -22,9 +31,6 @@ LOG_MODULE_REGISTER(main, LOG_LEVEL_DBG);
 int err = 0;
 int LED_STATE = LED_OFF;
 
-K_EVENT_DEFINE(button_events);
-#define BUTTON_EVENT BIT(0)
-
 static const struct gpio_dt_spec led_test = GPIO_DT_SPEC_GET(DT_ALIAS(ledtest), gpios);
 static const struct gpio_dt_spec button_test = GPIO_DT_SPEC_GET(DT_ALIAS(buttontest), gpios);
 
@@ -34,8 +40,6 @@ void button_test_callback(const struct device *dev, struct gpio_callback *cb, ui
 
 static int init(){
 
-    k_event_init(&button_events);
-
     if (!device_is_ready(button_test.port)) {
         LOG_ERR("gpio0 interface not ready.");  // logging module output
         return -1;  // exit code that will exit main()
@@ -47,7 +51,14 @@ static int init(){
         return err;
     }
 
-    err = gpio_pin_interrupt_configure_dt(&button_test, GPIO_INT_EDGE_TO_ACTIVE);
+    err = debounce_init(&button_test);
+    if (err < 0) {
+        LOG_ERR("Cannot read sw0 pin.");
+        return err;
+    }
+
+    // both edges, so release bounce is filtered as well as press bounce
+    err = gpio_pin_interrupt_configure_dt(&button_test, GPIO_INT_EDGE_BOTH);
     if (err < 0) {
         LOG_ERR("Cannot attach callback to sw0.");
     }
@@ -67,46 +78,86 @@ static int init(){
     return 0;
 }
 
+static void toggle_led(const struct button_event *evt)
+{
+    LED_STATE = !LED_STATE;
+    gpio_pin_set_dt(&led_test, LED_STATE);
+    gpio_trace_sample(led_test.port);
+    uint64_t now = button_cycles();
+
+    latency_record(button_cycles_between(evt->cycles, now),
+                   button_cycles_between(evt->accepted_cycles, now));
+    if(LED_STATE == LED_OFF){
+        LOG_INF("Button OFF pressed, LED OFF\n");
+    } else {
+        LOG_INF("Button ON pressed, LED ON\n");
+    }
+}
+
 int main(void)
 {
     int err = init();
 
     if(err != 0){
+        app_finish(false);
         return -1;
     }
 
-    uint32_t events = k_event_wait(&button_events, BUTTON_EVENT, true, K_FOREVER);
+    // on native_sim, presses come from a --stimulus file if one is given
+    stimulus_start();
 
-    if (events & BUTTON_EVENT) {
-        LED_STATE = !LED_STATE;
-        gpio_pin_set_dt(&led_test, LED_STATE);
-        k_event_clear(&button_events, BUTTON_EVENT);
-        if(LED_STATE == LED_OFF){
-            LOG_INF("Button OFF pressed, LED OFF\n");
-        } else {
-            LOG_INF("Button ON pressed, LED ON\n");
-        }
-    }
+    struct button_event evt;
+    uint32_t events = 0;
+    uint32_t presses = 0;
+    int64_t start_ms = k_uptime_get();
+
+    // CONFIG_APP_RUN_DURATION_MS == 0 waits forever for the next event
+    k_timeout_t timeout = CONFIG_APP_RUN_DURATION_MS > 0 ?
+                          K_TIMEOUT_ABS_MS(start_ms + CONFIG_APP_RUN_DURATION_MS) : K_FOREVER;
 
-    uint32_t event_2 = k_event_wait(&button_events, BUTTON_EVENT, true, K_FOREVER);
+    // CONFIG_APP_PRESS_BUDGET == 0 keeps going until the run duration ends
+    while (CONFIG_APP_PRESS_BUDGET == 0 || presses < CONFIG_APP_PRESS_BUDGET) {
+        if (button_queue_get(&evt, timeout) != 0) {
+            break;  // run duration elapsed
+        }
 
-    if (event_2 & BUTTON_EVENT) {
-        LED_STATE = !LED_STATE;
-        gpio_pin_set_dt(&led_test, LED_STATE);
-        k_event_clear(&button_events, BUTTON_EVENT);
-        if(LED_STATE == LED_OFF){
-            LOG_INF("Button OFF pressed, LED OFF\n");
-        } else {
-            LOG_INF("Button ON pressed, LED ON\n");
+        events++;
+        if (evt.edge == BUTTON_EDGE_PRESS) {
+            presses++;
+            toggle_led(&evt);
         }
     }
 
+    uint32_t elapsed_ms = (uint32_t)(k_uptime_get() - start_ms);
+    uint32_t events_per_sec = elapsed_ms > 0 ? (uint32_t)((uint64_t)events * 1000U / elapsed_ms) : 0;
+
+    printk("SUMMARY events=%u presses=%u elapsed_ms=%u events_per_sec=%u\n",
+           events, presses, elapsed_ms, events_per_sec);
+
+    LOG_INF("button events dropped: %u", button_queue_dropped());
+    debounce_report();
+    latency_report();
+
     LOG_INF("exiting code");
-    return 0;
+
+#if defined(CONFIG_APP_LOG_BENCH)
+    log_health_bench();
+#endif
+#if defined(CONFIG_APP_LOG_HEALTH)
+    log_health_report();
+#endif
+    // every press in the budget handled, nothing lost on the way, and the
+    // stimulus (if any) replayed without errors
+    bool pass = (CONFIG_APP_PRESS_BUDGET == 0 || presses == CONFIG_APP_PRESS_BUDGET) &&
+                button_queue_dropped() == 0 && stimulus_ok();
+
+    app_finish(pass);
+    return pass ? 0 : -1;
 }
 
 
 void button_test_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
 {
-    k_event_post(&button_events, BUTTON_EVENT);
+    gpio_trace_sample(dev);
+    debounce_edge(pins);
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/logging/log.h>
+
+#include "gpio_trace.h"
+#include "leds.h"
+
+LOG_MODULE_DECLARE(main);
+
+#define LED_SPEC(node) GPIO_DT_SPEC_GET(node, gpios),
+
+static const struct gpio_dt_spec leds[] = {
+    DT_FOREACH_CHILD(LEDS_NODE, LED_SPEC)
+};
+
+BUILD_ASSERT(ARRAY_SIZE(leds) == LEDS_COUNT);
+
+// LEDs grouped by GPIO controller, built once in leds_init()
+struct led_port {
+    const struct device *port;
+    uint32_t leds;  // table bits that live on this port
+};
+
+static struct led_port ports[LEDS_COUNT];
+static size_t port_count;
+
+static uint32_t frame_state;
+static struct k_spinlock frame_lock;
+
+static struct led_port *port_group(const struct device *port)
+{
+    for (size_t i = 0; i < port_count; i++) {
+        if (ports[i].port == port) {
+            return &ports[i];
+        }
+    }
+
+    ports[port_count].port = port;
+    ports[port_count].leds = 0;
+    return &ports[port_count++];
+}
+
+int leds_init(void)
+{
+    for (size_t i = 0; i < ARRAY_SIZE(leds); i++) {
+        if (!device_is_ready(leds[i].port)) {
+            LOG_ERR("%s interface not ready.", leds[i].port->name);
+            return -ENODEV;
+        }
+
+        int err = gpio_pin_configure_dt(&leds[i], GPIO_OUTPUT_INACTIVE);
+
+        if (err < 0) {
+            LOG_ERR("Cannot configure LED %u output pin.", (unsigned int)i);
+            return err;
+        }
+
+        port_group(leds[i].port)->leds |= BIT(i);
+    }
+
+    frame_state = 0;
+    return 0;
+}
+
+int leds_update(uint32_t mask, uint32_t frame)
+{
+    k_spinlock_key_t key = k_spin_lock(&frame_lock);
+    uint32_t next = (frame_state & ~mask) | (frame & mask);
+    uint32_t changed = (next ^ frame_state) & LEDS_ALL;
+    int ret = 0;
+
+    for (size_t p = 0; p < port_count && changed != 0; p++) {
+        uint32_t bits = changed & ports[p].leds;
+        gpio_port_pins_t pins = 0;
+        gpio_port_value_t values = 0;
+
+        if (bits == 0) {
+            continue;
+        }
+
+        // logical values; the driver applies GPIO_ACTIVE_LOW inversion
+        for (size_t i = 0; bits != 0; i++, bits >>= 1) {
+            if (bits & 1U) {
+                pins |= BIT(leds[i].pin);
+                if (next & BIT(i)) {
+                    values |= BIT(leds[i].pin);
+                }
+            }
+        }
+
+        int err = gpio_port_set_masked(ports[p].port, pins, values);
+
+        if (err < 0) {
+            ret = err;
+        }
+        gpio_trace_sample(ports[p].port);
+    }
+
+    frame_state = next;
+    k_spin_unlock(&frame_lock, key);
+
+    return ret;
+}
+
+uint32_t leds_get(void)
+{
+    return frame_state;
+}
@@ -0,0 +1,38 @@
+#ifndef LEDS_H
+#define LEDS_H
+
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+
+// The LED table is every child of the gpio-leds node that holds the `ledtest`
+// alias, in devicetree order. Bit n of a frame drives table entry n.
+#define LEDS_NODE DT_PARENT(DT_ALIAS(ledtest))
+#define LEDS_COUNT DT_CHILD_NUM(LEDS_NODE)
+
+// table index of the `ledtest` alias itself
+#define LEDS_TEST_IDX DT_NODE_CHILD_IDX(DT_ALIAS(ledtest))
+
+#define LEDS_ALL BIT_MASK(LEDS_COUNT)
+
+// LED frames are 32-bit masks
+#define LEDS_MAX 32
+
+BUILD_ASSERT(LEDS_COUNT <= LEDS_MAX, "LED frames are 32-bit masks");
+
+// Configures every LED in the table as an inactive output.
+int leds_init(void);
+
+// Sets the LEDs selected by `mask` to the matching bits of `frame` (1 = on)
+// and leaves the others alone. Costs one gpio_port_set_masked() call per GPIO
+// port touched, no matter how many LEDs change. Safe from ISR context.
+int leds_update(uint32_t mask, uint32_t frame);
+
+static inline int leds_write(uint32_t frame)
+{
+    return leds_update(LEDS_ALL, frame);
+}
+
+// Current logical frame.
+uint32_t leds_get(void);
+
+#endif // LEDS_H
@@ -13,38 +13,42 @@
 #include <zephyr/logging/log.h>
 // #include <zephyr/drivers/adc/adc_emul.h>
 
+#include "leds.h"
+#include "patterns.h"
+#include "sequencer.h"
+#include "swpwm.h"
+
+#include "app_exit.h"
+#include "log_health.h"
+
 LOG_MODULE_REGISTER(main, LOG_LEVEL_DBG);
 
 #define LED_ON 1
 #define LED_OFF 0
-#define HEARTBEAT_TOGGLE_INTERVAL_MS 500
+#define HEARTBEAT_TOGGLE_INTERVAL_MS CONFIG_APP_HEARTBEAT_TOGGLE_INTERVAL_MS
 
-static const struct gpio_dt_spec ledtest = GPIO_DT_SPEC_GET(DT_ALIAS(ledtest), gpios);
 int err = 0;
 
 static int init(){
-    // check if interface is ready
-    if (!device_is_ready(ledtest.port)) {
-        LOG_ERR("gpio0 interface not ready.");  // logging module output
-        return -1;  // exit code that will exit main()
-    }
-
-    // configure GPIO pin
-    err = gpio_pin_configure_dt(&ledtest, GPIO_OUTPUT_ACTIVE);  // ACTIVE referes to ON, not HIGH
+    // check the LED ports are ready and configure every LED in the table
+    err = leds_init();
     if (err < 0) {
-        LOG_ERR("Cannot configure GPIO output pin.");
+        LOG_ERR("Cannot configure LED table.");
         return err;
     }
-    
+
+    // the heartbeat LED starts ON, like the old GPIO_OUTPUT_ACTIVE setup
+    leds_update(BIT(LEDS_TEST_IDX), BIT(LEDS_TEST_IDX));
+
     return 0;
 }
 
-static void run(){
-    gpio_pin_set_dt(&ledtest, LED_ON);
+static __maybe_unused void run(){
+    leds_update(BIT(LEDS_TEST_IDX), BIT(LEDS_TEST_IDX));
     printk("LED ON\n");
     k_msleep(HEARTBEAT_TOGGLE_INTERVAL_MS);
 
-    gpio_pin_set_dt(&ledtest, LED_OFF);
+    leds_update(BIT(LEDS_TEST_IDX), 0);
     printk("LED OFF\n");
     k_msleep(HEARTBEAT_TOGGLE_INTERVAL_MS);
 }
@@ -54,12 +58,39 @@ int main(void)
     int err = init();
 
     if(err != 0){
+        app_finish(false);
         return -1;
     }
 
-    for(int i = 0; i<5 ; i++){
+    bool pass = true;
+
+#if defined(CONFIG_APP_LED_SEQUENCER)
+    pass &= sequencer_run(&app_pattern, CONFIG_APP_PATTERN_REPEAT) == 0;
+    sequencer_report();
+#else
+    for(int i = 0; i<CONFIG_APP_PATTERN_REPEAT ; i++){
         run();
     }
+#endif
 
-    return 0;
+#if defined(CONFIG_APP_SWPWM)
+    // brightness ramp across the table, channel n at (n + 1) / count
+    for (size_t ch = 0; ch < LEDS_COUNT; ch++) {
+        swpwm_set_duty(ch, (ch + 1) * CONFIG_APP_SWPWM_STEPS / LEDS_COUNT);
+    }
+    swpwm_start();
+    k_msleep(CONFIG_APP_SWPWM_RUN_MS);
+    swpwm_stop();
+    swpwm_benchmark();
+#endif
+
+#if defined(CONFIG_APP_LOG_BENCH)
+    log_health_bench();
+#endif
+#if defined(CONFIG_APP_LOG_HEALTH)
+    log_health_report();
+#endif
+
+    app_finish(pass);
+    return pass ? 0 : -1;
 }
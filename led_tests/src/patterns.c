@@ -0,0 +1,43 @@
+#include <zephyr/devicetree.h>
+#include <zephyr/sys/util.h>
+
+#include "leds.h"
+#include "patterns.h"
+
+#define TOGGLE_MS CONFIG_APP_HEARTBEAT_TOGGLE_INTERVAL_MS
+#define STEP_MS CONFIG_APP_PATTERN_STEP_MS
+
+#define PATTERN(_name, _frames) \
+    { .name = _name, .frames = _frames, .count = ARRAY_SIZE(_frames) }
+
+#if defined(CONFIG_APP_PATTERN_HEARTBEAT)
+
+// the original behaviour: ledtest on, then off
+static const struct led_frame frames[] = {
+    { BIT(LEDS_TEST_IDX), TOGGLE_MS },
+    { 0, TOGGLE_MS },
+};
+
+const struct led_pattern app_pattern = PATTERN("heartbeat", frames);
+
+#elif defined(CONFIG_APP_PATTERN_CHASE)
+
+// one frame per LED in the table, lit in devicetree order
+#define CHASE_FRAME(node) { BIT(DT_NODE_CHILD_IDX(node)), STEP_MS },
+
+static const struct led_frame frames[] = {
+    DT_FOREACH_CHILD(LEDS_NODE, CHASE_FRAME)
+};
+
+const struct led_pattern app_pattern = PATTERN("chase", frames);
+
+#elif defined(CONFIG_APP_PATTERN_BLINK_ALL)
+
+static const struct led_frame frames[] = {
+    { LEDS_ALL, STEP_MS },
+    { 0, STEP_MS },
+};
+
+const struct led_pattern app_pattern = PATTERN("blink_all", frames);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef PATTERNS_H
+#define PATTERNS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One step of an LED pattern: the LED table frame to show (see leds.h) and
+// how long to hold it.
+struct led_frame {
+    uint32_t mask;
+    uint32_t duration_ms;
+};
+
+struct led_pattern {
+    const char *name;
+    const struct led_frame *frames;
+    size_t count;
+};
+
+// Pattern selected by the CONFIG_APP_PATTERN_* choice. The frame tables are
+// const and built by the preprocessor from Kconfig and the devicetree LED
+// table, so they live in ROM and nothing is parsed at runtime.
+extern const struct led_pattern app_pattern;
+
+#endif // PATTERNS_H
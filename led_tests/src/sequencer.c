@@ -0,0 +1,132 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/printk.h>
+
+#include "leds.h"
+#include "sequencer.h"
+
+static void sequencer_expiry(struct k_timer *timer);
+
+K_TIMER_DEFINE(sequencer_timer, sequencer_expiry, NULL);
+K_SEM_DEFINE(sequencer_done, 0, 1);
+
+static const struct led_pattern *seq_pattern;
+static size_t seq_frame;         // index of the next frame to show
+static uint32_t seq_steps_left;
+static int64_t seq_deadline;     // absolute tick the next frame is due at
+
+// lateness = actual step time - deadline, jitter = change in lateness
+// between two consecutive steps (i.e. deviation of one frame duration)
+static uint32_t seq_steps;
+static int64_t seq_prev_late;
+static int64_t seq_late_max;
+static int64_t seq_late_sum;
+static int64_t seq_jitter_min;
+static int64_t seq_jitter_max;
+
+static void sequencer_step(void)
+{
+    int64_t now = k_uptime_ticks();
+    int64_t late = now - seq_deadline;
+    const struct led_frame *frame = &seq_pattern->frames[seq_frame];
+    uint32_t before = leds_get();
+
+    leds_write(frame->mask);
+
+    // keep the console trace of the ledtest LED the CI job looks for, with
+    // the kernel (on native_sim: simulated) time so timing can be checked
+    // without relying on wall-clock time. The first frame is always printed,
+    // even when init() already lit the LED, so the heartbeat keeps the
+    // original one line per frame (5 ON / 5 OFF); after that only changes
+    // are printed, which is the same thing for the heartbeat pattern.
+    if (seq_steps == 0 || ((before ^ frame->mask) & BIT(LEDS_TEST_IDX))) {
+        // 64-bit: a 32-bit microsecond count wraps after 71.6 minutes
+        unsigned long long t_us = k_ticks_to_us_near64(now);
+
+        if (frame->mask & BIT(LEDS_TEST_IDX)) {
+            printk("LED ON t_us=%llu\n", t_us);
+        } else {
+            printk("LED OFF t_us=%llu\n", t_us);
+        }
+    }
+
+    if (seq_steps > 0) {
+        int64_t jitter = late - seq_prev_late;
+
+        seq_jitter_min = MIN(seq_jitter_min, jitter);
+        seq_jitter_max = MAX(seq_jitter_max, jitter);
+    }
+    seq_late_max = MAX(seq_late_max, late);
+    seq_late_sum += late;
+    seq_prev_late = late;
+    seq_steps++;
+
+    // re-arm on the absolute schedule, never relative to "now"
+    seq_deadline += k_ms_to_ticks_ceil64(frame->duration_ms);
+    seq_frame = (seq_frame + 1) % seq_pattern->count;
+    seq_steps_left--;
+
+    // also armed after the last step, so the last frame runs its full
+    // duration before sequencer_run() returns
+    k_timer_start(&sequencer_timer, K_TIMEOUT_ABS_TICKS(seq_deadline), K_NO_WAIT);
+}
+
+static void sequencer_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+
+    if (seq_steps_left == 0) {
+        k_sem_give(&sequencer_done);
+        return;
+    }
+
+    sequencer_step();
+}
+
+int sequencer_run(const struct led_pattern *pattern, uint32_t repeat)
+{
+    if (repeat == 0 || pattern->count == 0) {
+        return 0;
+    }
+
+    seq_pattern = pattern;
+    seq_frame = 0;
+    seq_steps_left = repeat * pattern->count;
+
+    seq_steps = 0;
+    seq_prev_late = 0;
+    seq_late_max = 0;
+    seq_late_sum = 0;
+    seq_jitter_min = INT64_MAX;
+    seq_jitter_max = INT64_MIN;
+
+    k_sem_reset(&sequencer_done);
+
+    // first frame is shown right away and anchors the schedule
+    seq_deadline = k_uptime_ticks();
+    sequencer_step();
+
+    return k_sem_take(&sequencer_done, K_FOREVER);
+}
+
+static int32_t ticks_to_us_signed(int64_t ticks)
+{
+    int32_t us = (int32_t)k_ticks_to_us_near64(ticks < 0 ? -ticks : ticks);
+
+    return ticks < 0 ? -us : us;
+}
+
+void sequencer_report(void)
+{
+    if (seq_steps == 0) {
+        return;
+    }
+
+    // one printk per line: with CONFIG_LOG_PRINTK every call is a log message
+    printk("SEQUENCER pattern=%s frames=%u steps=%u late_us_max=%u late_us_avg=%u "
+           "jitter_us_min=%d jitter_us_max=%d\n",
+           seq_pattern->name, (uint32_t)seq_pattern->count, seq_steps,
+           (uint32_t)k_ticks_to_us_near64(seq_late_max),
+           (uint32_t)k_ticks_to_us_near64(seq_late_sum / seq_steps),
+           seq_steps > 1 ? ticks_to_us_signed(seq_jitter_min) : 0,
+           seq_steps > 1 ? ticks_to_us_signed(seq_jitter_max) : 0);
+}
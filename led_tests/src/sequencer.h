@@ -0,0 +1,17 @@
+#ifndef SEQUENCER_H
+#define SEQUENCER_H
+
+#include <stdint.h>
+
+#include "patterns.h"
+
+// Plays `pattern` `repeat` times from a single k_timer and blocks until done.
+// Frames are scheduled on absolute deadlines (start + sum of the previous
+// frame durations), so the time spent writing LEDs and printing never
+// accumulates into the pattern timing.
+int sequencer_run(const struct led_pattern *pattern, uint32_t repeat);
+
+// Prints the lateness/jitter recorded by the last sequencer_run().
+void sequencer_report(void);
+
+#endif // SEQUENCER_H
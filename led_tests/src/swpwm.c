@@ -0,0 +1,224 @@
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/printk.h>
+
+#if defined(CONFIG_ARCH_POSIX)
+#include "native_rtc.h"
+#endif
+
+#include "gpio_trace.h"
+#include "leds.h"
+#include "swpwm.h"
+
+#define STEPS CONFIG_APP_SWPWM_STEPS
+
+// channel counts the benchmark times the tick at: 0, LEDS_COUNT / 2 and
+// LEDS_COUNT
+#define BENCH_POINTS 3
+
+static void swpwm_expiry(struct k_timer *timer);
+
+K_TIMER_DEFINE(swpwm_timer, swpwm_expiry, NULL);
+K_MUTEX_DEFINE(swpwm_lock);
+// given every time a pending schedule is swapped in
+K_SEM_DEFINE(swpwm_swapped, 0, 1);
+
+static uint32_t duty[LEDS_COUNT];
+
+// schedule[b][s] = LED frame for step s; the tick plays schedule[active]
+static uint32_t schedule[2][STEPS];
+static atomic_t active;
+static atomic_t pending;  // inactive buffer is ready to be swapped in
+static bool running;
+
+// owned by the tick
+static uint32_t step;
+static uint32_t ticks;
+
+static void build_schedule(uint32_t *dst)
+{
+    for (uint32_t s = 0; s < STEPS; s++) {
+        uint32_t frame = 0;
+
+        for (size_t ch = 0; ch < LEDS_COUNT; ch++) {
+            if (duty[ch] > s) {
+                frame |= BIT(ch);
+            }
+        }
+        dst[s] = frame;
+    }
+}
+
+static void swap_pending(void)
+{
+    if (atomic_cas(&pending, 1, 0)) {
+        atomic_set(&active, !atomic_get(&active));
+        k_sem_give(&swpwm_swapped);
+    }
+}
+
+// one PWM step, driving only the channels in `mask`
+static void swpwm_step(uint32_t mask)
+{
+    if (step == 0) {
+        swap_pending();
+    }
+
+    uint32_t frame = schedule[atomic_get(&active)][step];
+
+    // leds_update() skips the driver call when nothing changed
+    leds_update(mask, frame);
+
+    step = (step + 1) % STEPS;
+    ticks++;
+}
+
+static void swpwm_expiry(struct k_timer *timer)
+{
+    ARG_UNUSED(timer);
+    swpwm_step(LEDS_ALL);
+}
+
+int swpwm_set_duty(size_t channel, uint32_t level)
+{
+    if (channel >= LEDS_COUNT || level > STEPS) {
+        return -EINVAL;
+    }
+
+    k_mutex_lock(&swpwm_lock, K_FOREVER);
+
+    duty[channel] = level;
+
+    if (!running) {
+        build_schedule(schedule[atomic_get(&active)]);
+    } else {
+        // Wait for the tick to pick up the previous change. Spinning here
+        // would never let the simulated clock reach the next tick on
+        // native_sim. A token left over from a swap nobody waited for only
+        // costs one more pass of the loop.
+        while (atomic_get(&pending)) {
+            k_sem_take(&swpwm_swapped, K_FOREVER);
+        }
+        build_schedule(schedule[!atomic_get(&active)]);
+        atomic_set(&pending, 1);
+    }
+
+    k_mutex_unlock(&swpwm_lock);
+    return 0;
+}
+
+void swpwm_start(void)
+{
+    step = 0;
+    ticks = 0;
+    running = true;
+    k_timer_start(&swpwm_timer, K_USEC(CONFIG_APP_SWPWM_TICK_US), K_USEC(CONFIG_APP_SWPWM_TICK_US));
+}
+
+void swpwm_stop(void)
+{
+    k_timer_stop(&swpwm_timer);
+    running = false;
+    // no tick is coming to take it, apply a pending change right away
+    swap_pending();
+    leds_write(0);
+    printk("SWPWM channels=%u steps=%u ticks=%u\n", LEDS_COUNT, STEPS, ticks);
+}
+
+// Wall-clock time for the benchmark. On native_sim the kernel clock is
+// simulated and does not advance while code runs, so use the host clock.
+static uint64_t bench_now_ns(void)
+{
+#if defined(CONFIG_ARCH_POSIX)
+    uint32_t nsec;
+    uint64_t sec;
+
+    native_rtc_gettime(RTC_CLOCK_REAL, &nsec, &sec);
+    return sec * NSEC_PER_SEC + nsec;
+#else
+    if (IS_ENABLED(CONFIG_TIMER_HAS_64BIT_CYCLE_COUNTER)) {
+        return k_cyc_to_ns_floor64(k_cycle_get_64());
+    }
+    return k_cyc_to_ns_floor64(k_cycle_get_32());
+#endif
+}
+
+// Mean cost of one tick driving the first `channels` channels, in ps.
+static uint64_t bench_ticks_ps(uint32_t channels)
+{
+    uint32_t iterations = CONFIG_APP_SWPWM_BENCH_ITERATIONS;
+    uint32_t mask = BIT_MASK(channels);
+
+    leds_write(0);
+    step = 0;
+
+    uint64_t start = bench_now_ns();
+
+    for (uint32_t i = 0; i < iterations; i++) {
+        swpwm_step(mask);
+    }
+
+    uint64_t elapsed = bench_now_ns() - start;
+
+    printk("SWPWM_BENCH_POINT channels=%u ns_per_tick=%u\n", channels,
+           (uint32_t)(elapsed / iterations));
+    return elapsed * 1000U / iterations;
+}
+
+void swpwm_benchmark(void)
+{
+    int64_t n = BENCH_POINTS;
+    int64_t sx = 0, sy = 0, sxx = 0, sxy = 0;
+    uint64_t all_ps = 0;
+
+    k_timer_stop(&swpwm_timer);
+    running = false;
+    swap_pending();
+
+    // time the channel update and the driver writes only, recording every
+    // frame in the gpio trace would dominate the result and fill the trace
+    gpio_trace_pause(true);
+
+    // The tick has a fixed part (period bookkeeping, frame lookup, one
+    // driver call per port) and a part that grows with the channel count.
+    // Dividing one total by LEDS_COUNT charges the fixed part to the
+    // channels, so fit a line through several counts instead.
+    for (int64_t k = 0; k < n; k++) {
+        int64_t x = k * LEDS_COUNT / (n - 1);
+        int64_t y = (int64_t)bench_ticks_ps((uint32_t)x);
+
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+        all_ps = (uint64_t)y;
+    }
+
+    gpio_trace_pause(false);
+    leds_write(0);
+
+    // least squares; the counts include 0 and LEDS_COUNT >= 1, so den > 0
+    int64_t den = n * sxx - sx * sx;
+    int64_t slope_ps = MAX((n * sxy - sx * sy) / den, 0);
+    int64_t fixed_ps = MAX((sy * sxx - sx * sxy) / den, 0);
+
+    uint32_t ns_per_tick = (uint32_t)(all_ps / 1000U);
+    uint32_t tick_ns = CONFIG_APP_SWPWM_TICK_US * NSEC_PER_USEC;
+    uint32_t cpu_permille = (uint32_t)(all_ps / tick_ns);
+    int64_t budget_ps = (int64_t)tick_ns * 1000 / 2;
+    uint32_t max_channels;
+
+    // a frame is a 32-bit mask, more channels would need a wider one
+    if (fixed_ps >= budget_ps) {
+        max_channels = 0;
+    } else if (slope_ps == 0) {
+        max_channels = LEDS_MAX;
+    } else {
+        max_channels = (uint32_t)MIN((budget_ps - fixed_ps) / slope_ps, LEDS_MAX);
+    }
+
+    printk("SWPWM_BENCH channels=%u steps=%u tick_us=%u ns_per_tick=%u ns_fixed=%u "
+           "ps_per_channel=%u cpu_permille=%u max_channels_50pct=%u\n",
+           LEDS_COUNT, STEPS, CONFIG_APP_SWPWM_TICK_US, ns_per_tick,
+           (uint32_t)(fixed_ps / 1000), (uint32_t)slope_ps, cpu_permille, max_channels);
+}
@@ -0,0 +1,32 @@
+#ifndef SWPWM_H
+#define SWPWM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Software PWM over the LED table (see leds.h), one channel per LED.
+//
+// Duty cycles are turned into a precomputed schedule holding the LED frame
+// of every PWM step, so the tick only looks up the next frame and writes it
+// when it differs from the current one. Duty changes build the schedule in a
+// second buffer that the tick swaps in at the start of the next period.
+
+// Sets the duty of `channel` to `level` steps out of CONFIG_APP_SWPWM_STEPS.
+int swpwm_set_duty(size_t channel, uint32_t level);
+
+void swpwm_start(void);
+void swpwm_stop(void);
+
+// Times CONFIG_APP_SWPWM_BENCH_ITERATIONS PWM ticks driving 0, half and all
+// of the channels, one line per count:
+//   SWPWM_BENCH_POINT channels=<n> ns_per_tick=<ns>
+// then fits cost = fixed + slope * channels through them and prints:
+//   SWPWM_BENCH channels=<n> steps=<n> tick_us=<us> ns_per_tick=<ns>
+//               ns_fixed=<ns> ps_per_channel=<ps> cpu_permille=<n>
+//               max_channels_50pct=<n>
+// ns_per_tick and cpu_permille are for all channels. max_channels_50pct is
+// how many channels fit in half a tick period at that fit, capped at
+// LEDS_MAX since a frame is a 32-bit mask.
+void swpwm_benchmark(void);
+
+#endif // SWPWM_H
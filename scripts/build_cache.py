@@ -0,0 +1,231 @@
+"""Build slots and the result cache for grade_submissions.py.
+
+Build slots
+-----------
+
+A full native_sim build spends nearly all of its time on the Zephyr kernel,
+drivers and generated headers, none of which depend on a student's C code.
+A slot is a persistent build directory that is reused for every submission
+with the same configuration key, a hash of:
+
+  * the Zephyr tree (VERSION and git HEAD)
+  * the board and extra CMake arguments
+  * every file of the app, cmake/, common/ and scripts/ trees that is not
+    C source: CMakeLists.txt, Kconfig, prj.conf, board .conf and .overlay
+    files, the CMake module and the overlay scripts, i.e. everything that
+    feeds CMake, Kconfig and the devicetree
+
+A submission is copied into the slot's source tree, rewriting only the
+files whose content differs and deleting the ones it doesn't have. The
+incremental ninja build then recompiles just those sources and relinks
+zephyr.exe against the kernel libraries that are already there. A
+configuration change gives a new key and so a new slot.
+
+Slots are locked while in use. Parallel graders with the same key get
+separate slots (<key>-0, <key>-1, ...), so the cache holds at most one warm
+slot per key and job.
+
+Result cache
+------------
+The result cache maps a hash of every input of a grading run, the input
+key, to its verdict and artifacts (logs, zephyr.exe, gpio traces). The key
+covers the same files as the configuration key plus the C sources, and the
+grading harness itself (the grader's scripts and run options). A
+resubmission that only touches files outside those trees gets the stored
+result back without building or running anything.
+"""
+
+import fcntl
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import tempfile
+from contextlib import contextmanager
+from pathlib import Path
+
+# only the compiler reads these; everything else is configuration
+SOURCE_SUFFIXES = {'.c', '.h', '.S'}
+
+# overlay that older led_tests builds generated into the source tree
+GENERATED = {'native_sim.overlay'}
+
+
+def zephyr_tree(workspace):
+    base = os.environ.get('ZEPHYR_BASE')
+    return Path(base) if base else Path(workspace) / 'zephyr'
+
+
+def zephyr_version(workspace):
+    """Identify the Zephyr tree by its VERSION file and git HEAD."""
+    zephyr = zephyr_tree(workspace)
+    version = ''
+    try:
+        version = (zephyr / 'VERSION').read_text()
+    except OSError:
+        pass
+    try:
+        version += subprocess.run(['git', '-C', str(zephyr), 'rev-parse', 'HEAD'],
+                                  capture_output=True, text=True, check=True).stdout
+    except (OSError, subprocess.CalledProcessError):
+        pass
+    return version
+
+
+# directories that are never part of a tree: VCS data, build output and
+# Python's bytecode caches
+SKIP_DIRS = {'build', '__pycache__'}
+
+
+def _skip_dir(name):
+    return name.startswith('.') or name in SKIP_DIRS
+
+
+def tree_files(trees):
+    """Yield (relative path, absolute path) for every file of the trees.
+
+    `trees` maps a destination directory name to the source directory.
+    """
+    for name, root in sorted(trees.items()):
+        root = Path(root)
+        for dirpath, dirnames, filenames in os.walk(root):
+            dirnames[:] = sorted(d for d in dirnames if not _skip_dir(d))
+            for filename in sorted(filenames):
+                if filename in GENERATED:
+                    continue
+                path = Path(dirpath) / filename
+                yield Path(name) / path.relative_to(root), path
+
+
+def _hash(trees, workspace, extra, sources):
+    h = hashlib.sha256()
+    h.update(zephyr_version(workspace).encode())
+    for item in extra:
+        h.update(b'\0' + str(item).encode())
+    for rel, path in tree_files(trees):
+        if not sources and path.suffix in SOURCE_SUFFIXES:
+            continue
+        h.update(b'\0' + str(rel).encode() + b'\0')
+        h.update(path.read_bytes())
+    return h.hexdigest()[:16]
+
+
+def config_key(trees, workspace, extra=()):
+    """Hash everything that changes the kernel build, but not the C sources."""
+    return _hash(trees, workspace, extra, sources=False)
+
+
+def input_key(trees, workspace, extra=()):
+    """Hash everything that changes the outcome of a grading run."""
+    return _hash(trees, workspace, extra, sources=True)
+
+
+def sync_tree(trees, dest):
+    """Make `dest` an exact copy of the trees, writing only changed files.
+
+    Unchanged files keep their old timestamps, so ninja does not rebuild
+    them. Files under `dest` that are in none of the trees are removed, so a
+    source left behind by an earlier submission can't be compiled or
+    included into this one; build directories and generated files are kept.
+    Returns the number of files written and the number removed.
+    """
+    dest = Path(dest)
+    wanted = set()
+    written = 0
+    for rel, path in tree_files(trees):
+        wanted.add(rel)
+        target = dest / rel
+        data = path.read_bytes()
+        try:
+            if target.read_bytes() == data:
+                continue
+        except OSError:
+            target.parent.mkdir(parents=True, exist_ok=True)
+        target.write_bytes(data)
+        shutil.copymode(path, target)
+        written += 1
+
+    removed = 0
+    dirs = []
+    for dirpath, dirnames, filenames in os.walk(dest):
+        dirnames[:] = [d for d in dirnames if not _skip_dir(d)]
+        dirpath = Path(dirpath)
+        dirs.append(dirpath)
+        for filename in filenames:
+            if filename in GENERATED or (dirpath / filename).relative_to(dest) in wanted:
+                continue
+            (dirpath / filename).unlink()
+            removed += 1
+    # deepest first, so a directory emptied above goes with its parents
+    for dirpath in reversed(dirs[1:]):
+        if not any(dirpath.iterdir()):
+            dirpath.rmdir()
+    return written, removed
+
+
+@contextmanager
+def acquire_slot(cache, key):
+    """Lock and yield the first free slot directory for `key`."""
+    cache = Path(cache).resolve()
+    cache.mkdir(parents=True, exist_ok=True)
+    index = 0
+    while True:
+        slot = cache / f'{key}-{index}'
+        slot.mkdir(exist_ok=True)
+        lock = open(slot / 'lock', 'w')
+        try:
+            fcntl.flock(lock, fcntl.LOCK_EX | fcntl.LOCK_NB)
+        except BlockingIOError:
+            lock.close()
+            index += 1
+            continue
+        try:
+            yield slot
+        finally:
+            fcntl.flock(lock, fcntl.LOCK_UN)
+            lock.close()
+        return
+
+
+def load_result(cache, key, out):
+    """Copy a cached run's artifacts into `out` and return its result.
+
+    Returns None on a miss.
+    """
+    entry = Path(cache) / key
+    try:
+        result = json.loads((entry / 'result.json').read_text())
+    except (OSError, ValueError):
+        return None
+
+    out = Path(out)
+    for path in entry.iterdir():
+        if path.is_file() and path.name != 'result.json':
+            shutil.copy2(path, out / path.name)
+    for phase in result['phases'].values():
+        if 'log' in phase:
+            phase['log'] = str(out / Path(phase['log']).name)
+    return result
+
+
+def store_result(cache, key, result, out):
+    """Store the result and the top-level files of `out` under `key`."""
+    cache = Path(cache)
+    cache.mkdir(parents=True, exist_ok=True)
+    entry = cache / key
+    if entry.exists():
+        return
+
+    # build the entry next to its final place and rename it in, so readers
+    # never see a half-written one
+    tmp = Path(tempfile.mkdtemp(dir=cache, prefix=f'.{key}-'))
+    for path in Path(out).iterdir():
+        if path.is_file():
+            shutil.copy2(path, tmp / path.name)
+    (tmp / 'result.json').write_text(json.dumps(result, indent=2) + '\n')
+    try:
+        tmp.rename(entry)
+    except OSError:
+        # another grader stored the same key first
+        shutil.rmtree(tmp, ignore_errors=True)
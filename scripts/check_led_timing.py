@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""Check the heartbeat timing printed by led_tests.
+
+The sequencer prints "LED ON t_us=<n>" / "LED OFF t_us=<n>" with 64-bit kernel
+time, which on native_sim is simulated time and does not wrap on long runs. This checks every ON->OFF and OFF->ON
+interval against the expected toggle interval, so timing is verified even
+when the simulation runs much faster than real time.
+"""
+
+import argparse
+import re
+import sys
+from pathlib import Path
+
+LINE = re.compile(r'LED (ON|OFF) t_us=(\d+)')
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('log', help='captured zephyr.exe output')
+    parser.add_argument('--interval-ms', type=float, default=500,
+                        help='expected time between toggles (default: 500)')
+    parser.add_argument('--tolerance-us', type=float, default=1000,
+                        help='allowed deviation per interval (default: 1000)')
+    parser.add_argument('--min-toggles', type=int, default=2,
+                        help='fail if fewer toggles were seen (default: 2)')
+    args = parser.parse_args()
+
+    expected_us = args.interval_ms * 1000
+    prev = None
+    toggles = 0
+    worst = 0.0
+    errors = 0
+
+    for line in Path(args.log).read_text(errors='replace').splitlines():
+        m = LINE.search(line)
+        if not m:
+            continue
+
+        state, t_us = m.group(1), int(m.group(2))
+        toggles += 1
+
+        if prev is not None:
+            if state == prev[0]:
+                print(f"Error: LED {state} twice in a row at t_us={t_us}")
+                errors += 1
+            deviation = (t_us - prev[1]) - expected_us
+            worst = max(worst, abs(deviation))
+            if abs(deviation) > args.tolerance_us:
+                print(f"Error: interval ending at t_us={t_us} is off by {deviation:.0f} us")
+                errors += 1
+
+        prev = (state, t_us)
+
+    print(f"toggles={toggles} worst_deviation_us={worst:.0f}")
+
+    if toggles < args.min_toggles:
+        print(f"Error: expected at least {args.min_toggles} toggles")
+        errors += 1
+
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,258 @@
+#!/usr/bin/env python3
+"""Check an LED waveform in a gpio trace recorded on native_sim.
+
+Reads the .bin or .vcd trace written by CONFIG_APP_GPIO_TRACE in a single
+streaming pass with constant memory, so multi-gigabyte soak traces are fine.
+For one pin of one controller (gpio<port>, default gpio0) it checks:
+
+  * period     time between rising edges, expected 2 x interval
+  * duty cycle high time / period
+  * toggles    number of level changes
+
+and prints the period jitter distribution (deviation from the expected
+period). Exits 1 if any check fails.
+
+    check_waveform.py gpio_trace.bin --pin 10 --interval-ms 500
+    check_waveform.py gpio_trace.vcd --port 1 --pin 4
+"""
+
+import argparse
+import json
+import math
+import struct
+import sys
+
+BIN_MAGIC = b'GTRC'
+BIN_PREFIX = struct.Struct('<4sIQ')     # magic, version, count
+# version 1: gpio0 only
+BIN_V1_HEADER = struct.Struct('<II')    # initial, dropped
+BIN_V1_ENTRY = struct.Struct('<QII')    # t_ns, levels, changed
+# version 2: gpio0..gpio<ports - 1>
+BIN_V2_HEADER = struct.Struct('<II')    # dropped, ports, then uint32 initial[ports]
+BIN_V2_ENTRY = struct.Struct('<QIIII')  # t_ns, levels, changed, port, reserved
+CHUNK_ENTRIES = 65536
+
+
+def read_exact(f, size):
+    data = f.read(size)
+    if len(data) != size:
+        raise ValueError('truncated header')
+    return data
+
+
+def bin_edges(path, pin, port=0):
+    """Yield (t_ns, level) for every change of gpio<port> `pin` in a binary trace."""
+    bit = 1 << pin
+
+    with open(path, 'rb') as f:
+        magic, version, count = BIN_PREFIX.unpack(read_exact(f, BIN_PREFIX.size))
+        if magic != BIN_MAGIC or version not in (1, 2):
+            raise ValueError('not a version 1 or 2 gpio trace')
+
+        if version == 1:
+            initial, dropped = BIN_V1_HEADER.unpack(read_exact(f, BIN_V1_HEADER.size))
+            if port != 0:
+                raise ValueError('a version 1 trace only holds gpio0')
+            entry = BIN_V1_ENTRY
+        else:
+            dropped, ports = BIN_V2_HEADER.unpack(read_exact(f, BIN_V2_HEADER.size))
+            levels = struct.unpack(f'<{ports}I', read_exact(f, 4 * ports))
+            if port >= ports:
+                raise ValueError(f'trace holds gpio0..gpio{ports - 1}, not gpio{port}')
+            initial = levels[port]
+            entry = BIN_V2_ENTRY
+        if dropped:
+            print(f"Warning: recorder dropped {dropped} transitions", file=sys.stderr)
+
+        yield 0, bool(initial & bit)
+
+        while True:
+            chunk = f.read(entry.size * CHUNK_ENTRIES)
+            if not chunk:
+                break
+            chunk = chunk[:len(chunk) - len(chunk) % entry.size]
+            for t_ns, levels, changed, *rest in entry.iter_unpack(chunk):
+                if changed & bit and (not rest or rest[0] == port):
+                    yield t_ns, bool(levels & bit)
+
+
+def vcd_edges(path, pin, port=0):
+    """Yield (t_ns, level) for every change of gpio<port> `pin` in a VCD trace."""
+    ident = None
+    scope = None
+    scale_ns = 1.0
+    t_ns = 0
+    units = {'s': 1e9, 'ms': 1e6, 'us': 1e3, 'ns': 1.0, 'ps': 1e-3, 'fs': 1e-6}
+
+    with open(path, 'r') as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            if line.startswith('$timescale'):
+                spec = line.replace('$timescale', '').replace('$end', '').strip()
+                num = spec.rstrip('abcdefghijklmnopqrstuvwxyz').strip()
+                scale_ns = float(num or 1) * units[spec[len(num):].strip()]
+            elif line.startswith('$scope'):
+                # $scope module gpio<N> $end
+                fields = line.split()
+                scope = fields[2] if len(fields) >= 3 else None
+            elif line.startswith('$upscope'):
+                scope = None
+            elif line.startswith('$var'):
+                # $var wire 1 <id> pin<N> $end
+                fields = line.split()
+                if (len(fields) >= 5 and fields[4] == f'pin{pin}'
+                        and scope == f'gpio{port}'):
+                    ident = fields[3]
+            elif line.startswith('#'):
+                t_ns = int(int(line[1:]) * scale_ns)
+            elif line[0] in '01' and line[1:] == ident:
+                yield t_ns, line[0] == '1'
+
+
+class Stats:
+    """Streaming min/max/mean/stddev (Welford) plus a fixed-width histogram."""
+
+    def __init__(self, bucket):
+        self.bucket = bucket
+        self.n = 0
+        self.mean = 0.0
+        self.m2 = 0.0
+        self.min = math.inf
+        self.max = -math.inf
+        self.hist = {}
+
+    def add(self, x):
+        self.n += 1
+        delta = x - self.mean
+        self.mean += delta / self.n
+        self.m2 += delta * (x - self.mean)
+        self.min = min(self.min, x)
+        self.max = max(self.max, x)
+        b = math.floor(x / self.bucket)
+        self.hist[b] = self.hist.get(b, 0) + 1
+
+    def stddev(self):
+        return math.sqrt(self.m2 / self.n) if self.n > 1 else 0.0
+
+    def percentile(self, pct):
+        """Upper edge of the bucket holding `pct`, clamped to [min, max]."""
+        rank = math.ceil(self.n * pct / 100)
+        seen = 0
+        for b in sorted(self.hist):
+            seen += self.hist[b]
+            if seen >= rank:
+                return min(max((b + 1) * self.bucket, self.min), self.max)
+        return self.max
+
+    def summary(self):
+        if self.n == 0:
+            return {'count': 0}
+        return {'count': self.n, 'min': self.min, 'max': self.max, 'mean': self.mean,
+                'stddev': self.stddev(), 'p50': self.percentile(50),
+                'p99': self.percentile(99)}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('trace', help='gpio_trace.bin or gpio_trace.vcd')
+    parser.add_argument('--port', type=int, default=0,
+                        help='controller, gpio<N> (default: 0)')
+    parser.add_argument('--pin', type=int, default=10, help='pin (default: 10)')
+    parser.add_argument('--interval-ms', type=float, default=500,
+                        help='toggle interval, half the period (default: 500)')
+    parser.add_argument('--period-tol-us', type=float, default=1000,
+                        help='allowed period deviation (default: 1000)')
+    parser.add_argument('--duty', type=float, default=50, help='expected duty %% (default: 50)')
+    parser.add_argument('--duty-tol', type=float, default=1.0,
+                        help='allowed duty deviation in %% points (default: 1)')
+    parser.add_argument('--toggles', type=int, help='exact number of toggles expected')
+    parser.add_argument('--min-toggles', type=int, default=2,
+                        help='fewest toggles accepted (default: 2)')
+    parser.add_argument('--bucket-us', type=float, default=1.0,
+                        help='jitter histogram bucket width (default: 1)')
+    parser.add_argument('--json', action='store_true', help='print the report as JSON')
+    args = parser.parse_args()
+
+    edges = vcd_edges if args.trace.endswith('.vcd') else bin_edges
+    period_ns = 2 * args.interval_ms * 1e6
+    tol_ns = args.period_tol_us * 1e3
+
+    jitter = Stats(args.bucket_us * 1e3)   # period - expected, ns
+    duty = Stats(0.01)                     # %
+    toggles = 0
+    period_errors = 0
+    duty_errors = 0
+    last_rise = None
+    last_fall = None
+    level = None
+
+    for t_ns, new_level in edges(args.trace, args.pin, args.port):
+        if level is None:
+            level = new_level      # initial level, not a transition
+            continue
+        if new_level == level:
+            continue
+        level = new_level
+        toggles += 1
+
+        if not new_level:
+            last_fall = t_ns
+            continue
+
+        if last_rise is not None:
+            period = t_ns - last_rise
+            jitter.add(period - period_ns)
+            if abs(period - period_ns) > tol_ns:
+                period_errors += 1
+
+            if last_fall is not None and last_fall > last_rise:
+                d = 100.0 * (last_fall - last_rise) / period
+                duty.add(d)
+                if abs(d - args.duty) > args.duty_tol:
+                    duty_errors += 1
+        last_rise = t_ns
+
+    failures = []
+    if period_errors:
+        failures.append(f'{period_errors} periods outside +/-{args.period_tol_us:g} us')
+    if duty_errors:
+        failures.append(f'{duty_errors} duty cycles outside {args.duty:g} +/-{args.duty_tol:g} %')
+    if args.toggles is not None and toggles != args.toggles:
+        failures.append(f'{toggles} toggles, expected {args.toggles}')
+    if toggles < args.min_toggles:
+        failures.append(f'{toggles} toggles, expected at least {args.min_toggles}')
+
+    report = {
+        'port': args.port,
+        'pin': args.pin,
+        'toggles': toggles,
+        'expected_period_ns': period_ns,
+        'jitter_ns': jitter.summary(),
+        'duty_pct': duty.summary(),
+        'result': 'FAIL' if failures else 'PASS',
+        'failures': failures,
+    }
+
+    if args.json:
+        print(json.dumps(report, indent=2))
+    else:
+        j = report['jitter_ns']
+        print(f"gpio{args.port} pin{args.pin}: toggles={toggles} periods={j['count']}")
+        if j['count']:
+            print(f"  jitter_ns min={j['min']:.0f} p50={j['p50']:.0f} p99={j['p99']:.0f} "
+                  f"max={j['max']:.0f} mean={j['mean']:.1f} stddev={j['stddev']:.1f}")
+        d = report['duty_pct']
+        if d['count']:
+            print(f"  duty_pct min={d['min']:.2f} mean={d['mean']:.2f} max={d['max']:.2f}")
+        for failure in failures:
+            print(f"Error: {failure}")
+        print(f"WAVEFORM {report['result']}")
+
+    return 1 if failures else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+"""Decode the output of an app built with overlay-dictionary-log.conf.
+
+The firmware writes its log as a hex-encoded dictionary stream mixed with any
+plain text the native_sim runner prints itself. This walks the capture in
+order, decodes each dictionary record with Zephyr's dictionary log parser and
+the build's log_dictionary.json, and prints the decoded text and the runner's
+lines as they were interleaved, so the same greps used on a text-logging
+build keep working:
+
+    zephyr.exe | tee raw.log
+    decode_dictionary_log.py build/zephyr/log_dictionary.json raw.log | grep "LED ON"
+
+Records are told apart from text by the dictionary framing, not by how the
+text looks: a record is a message header (see log_output_dict.h) whose
+lengths give the exact number of hex digits that follow. Anything that does
+not parse as one is a runner line and is printed unchanged.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+from pathlib import Path
+
+HEX_RUN = re.compile(r'[0-9a-fA-F]*')
+
+# log_output_dict.h, dictionary database version 3
+MSG_NORMAL = 0
+MSG_DROPPED = 1
+DATABASE_VERSION = 3
+
+
+class Framing:
+    """Record sizes of the target that wrote the stream."""
+
+    def __init__(self, database):
+        endian = '<' if database.is_tgt_little_endian() else '>'
+        pointer = 'Q' if database.is_tgt_64bit() else 'I'
+        timestamp = 'Q' if 'CONFIG_LOG_TIMESTAMP_64BIT' in database.get_kconfigs() else 'I'
+
+        # type, domain/level, package_len, data_len, source, timestamp
+        self.normal = struct.Struct(endian + 'BBHH' + pointer + timestamp)
+        # type, number of dropped messages
+        self.dropped = struct.Struct(endian + 'BH')
+
+    def record_end(self, text, pos, run_end):
+        """End of the record starting at `pos`, None if there is none.
+
+        `run_end` is the end of the hex digit run starting at `pos`. Raises
+        EOFError if the header is valid but the capture stops inside it.
+        """
+        def data(size):
+            if pos + 2 * size > run_end:
+                if run_end == len(text):
+                    raise EOFError
+                return None
+            return bytes.fromhex(text[pos:pos + 2 * size])
+
+        head = data(1)
+        if head is None:
+            return None
+
+        if head[0] == MSG_DROPPED:
+            return pos + 2 * self.dropped.size if data(self.dropped.size) else None
+        if head[0] != MSG_NORMAL:
+            return None
+
+        header = data(self.normal.size)
+        if header is None:
+            return None
+        _, _, package_len, data_len, _, _ = self.normal.unpack(header)
+        if package_len == 0:
+            return None
+
+        size = self.normal.size + package_len + data_len
+        return pos + 2 * size if data(size) else None
+
+
+def frames(text, framing):
+    """Yield ('log', bytes) for every record and ('text', line) for every
+    other line of the capture, in stream order."""
+    pos = 0
+
+    while pos < len(text):
+        run_end = HEX_RUN.match(text, pos).end()
+        try:
+            end = framing.record_end(text, pos, run_end) if run_end > pos else None
+        except EOFError:
+            print("Warning: capture ends inside a log record", file=sys.stderr)
+            return
+
+        if end is not None:
+            yield 'log', bytes.fromhex(text[pos:end])
+            pos = end
+            continue
+
+        newline = text.find('\n', pos)
+        end = len(text) if newline < 0 else newline + 1
+        line = text[pos:end].strip()
+        if line:
+            yield 'text', line
+        pos = end
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('database', help='build/zephyr/log_dictionary.json')
+    parser.add_argument('capture', help="captured zephyr.exe output, '-' for stdin")
+    parser.add_argument('--zephyr-base', default=os.environ.get('ZEPHYR_BASE'),
+                        help='Zephyr tree providing the parser (default: $ZEPHYR_BASE)')
+    args = parser.parse_args()
+
+    if not args.zephyr_base:
+        sys.exit("Error: ZEPHYR_BASE not set, pass --zephyr-base")
+
+    parser_dir = Path(args.zephyr_base) / 'scripts' / 'logging' / 'dictionary'
+    if not (parser_dir / 'dictionary_parser').is_dir():
+        sys.exit(f"Error: {parser_dir / 'dictionary_parser'} not found")
+
+    sys.path.insert(0, str(parser_dir))
+    import dictionary_parser
+    from dictionary_parser.log_database import LogDatabase
+
+    database = LogDatabase.read_json_database(args.database)
+    if database is None:
+        sys.exit(f"Error: cannot read {args.database}")
+    if database.get_version() != DATABASE_VERSION:
+        sys.exit(f"Error: dictionary database version {database.get_version()}, "
+                 f"only {DATABASE_VERSION} is supported")
+    log_parser = dictionary_parser.get_parser(database)
+
+    if args.capture == '-':
+        text = sys.stdin.read()
+    else:
+        text = Path(args.capture).read_text(errors='replace')
+
+    ok = True
+    for kind, item in frames(text, Framing(database)):
+        if kind == 'text':
+            # runner output that never went through the log stream
+            print(item)
+        else:
+            sys.stdout.flush()
+            ok = log_parser.parse_log_data(item) is not False and ok
+
+    return 0 if ok else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,413 @@
+"""Small devicetree source (DTS) parser for the overlay scripts.
+
+Parses the subset of DTS that board overlays use into a tree of nodes:
+
+  * // and /* */ comments, so commented-out nodes are really gone
+  * #include "..." / #include <...> and /include/ "...": quoted includes are
+    resolved next to the including file, then in the include directories;
+    binding headers that cannot be found (<zephyr/dt-bindings/...>) are
+    recorded and skipped, their macros are not needed here
+  * other preprocessor lines (#define, #if, ...) are skipped
+  * labels (`led0: led_0 { ... };`), node references (`&gpio0 { ... };`,
+    `= <&gpio0 10 0>`), nested nodes, /delete-node/ and /delete-property/
+  * path references (`&{/soc/gpio@0} { ... };`, `/delete-node/ &{/a/b};`)
+    resolve through the node at that path; a path the file never defines
+    (a node of the board's base tree) is created there
+  * nodes with the same path are merged, later properties win, as dtc does
+
+References to labels the file never defines are kept in `Tree.refs`, as
+they belong to the base tree, which is not parsed here.
+
+The source is scanned once with a single regex, so parsing is linear in the
+file size. Parsed trees are cached in memory by (path, content hash) and,
+with `cache_dir`, on disk as JSON so later processes skip the parse; a disk
+entry is only used while every file it included still has the same hash.
+
+    tree = dts_parser.parse_file('boards/native_posix.overlay')
+    for alias, target in tree.aliases().items():
+        ...
+"""
+
+import hashlib
+import json
+import re
+from pathlib import Path
+
+CACHE_VERSION = 2
+
+TOKEN = re.compile(r'''
+    (?P<ws>\s+)
+  | (?P<comment>//[^\n]*|/\*.*?\*/)
+  | (?P<directive>\#\s*(?:include|define|undef|if|ifdef|ifndef|elif|else|endif|pragma)\b
+                  (?:[^\n\\]|\\.)*)
+  | (?P<string>"(?:[^"\\]|\\.)*")
+  | (?P<cells><(?:[^<>]|<<|>>)*>)
+  | (?P<bytes>\[[^\]]*\])
+  | (?P<keyword>/[a-z][a-z0-9-]*/)
+  | (?P<ref>&\{[^}]*\}|&[A-Za-z_]\w*)
+  | (?P<label>[A-Za-z_]\w*:)
+  | (?P<name>[\w,.+\#?@-]+)
+  | (?P<punct>[{};=,/])
+''', re.VERBOSE | re.DOTALL)
+
+INCLUDE = re.compile(r'\#\s*include\s*([<"])([^>"]+)[>"]')
+
+
+class DtsError(Exception):
+    pass
+
+
+class Node:
+    def __init__(self, name, parent=None):
+        self.name = name
+        self.parent = parent
+        self.labels = []
+        self.props = {}       # name -> list of (kind, text) values
+        self.children = {}    # name -> Node, in source order
+
+    def child(self, name):
+        if name not in self.children:
+            self.children[name] = Node(name, self)
+        return self.children[name]
+
+    def walk(self):
+        yield self
+        for child in self.children.values():
+            yield from child.walk()
+
+    def to_dict(self):
+        return {'name': self.name, 'labels': self.labels,
+                'props': {k: [list(v) for v in vals] for k, vals in self.props.items()},
+                'children': [c.to_dict() for c in self.children.values()]}
+
+    @classmethod
+    def from_dict(cls, d, parent=None):
+        node = cls(d['name'], parent)
+        node.labels = list(d['labels'])
+        node.props = {k: [tuple(v) for v in vals] for k, vals in d['props'].items()}
+        for c in d['children']:
+            child = cls.from_dict(c, node)
+            node.children[child.name] = child
+        return node
+
+
+class Tree:
+    def __init__(self):
+        self.root = Node('/')
+        self.refs = {}               # label -> Node for &label { } of unknown labels
+        self.includes = []           # files that were read, the main file first
+        self.missing_includes = []   # includes that could not be found
+        # label -> Node for every label in the tree, kept up to date by
+        # add_labels() and delete_node(), so resolving &label is a lookup
+        # rather than a walk of the whole tree
+        self.label_index = {}
+
+    def labels(self):
+        """Map every label to its node."""
+        return dict(self.label_index)
+
+    def add_labels(self, node, labels):
+        for label in labels:
+            if label not in node.labels:
+                node.labels.append(label)
+            self.label_index[label] = node
+
+    def delete_node(self, parent, name):
+        """Remove a child node and drop the labels of its whole subtree."""
+        child = parent.children.pop(name, None)
+        if child is None:
+            return
+        for node in child.walk():
+            for label in node.labels:
+                if self.label_index.get(label) is node:
+                    del self.label_index[label]
+
+    def delete_label(self, label):
+        """Remove the node carrying `label`, as /delete-node/ &label does."""
+        node = self.label_index.get(label)
+        if node is not None and node.parent is not None:
+            self.delete_node(node.parent, node.name)
+        else:
+            self.refs.pop(label, None)
+
+    def delete_ref(self, ref):
+        """Remove the node `&label` or `&{/path}` points at."""
+        if ref.startswith('&{'):
+            node = self.node(ref[2:-1])
+            if node is not None and node.parent is not None:
+                self.delete_node(node.parent, node.name)
+        else:
+            self.delete_label(ref[1:])
+
+    def ref_target(self, ref):
+        """Node to extend for `&label { ... };` or `&{/path} { ... };`."""
+        if ref.startswith('&{'):
+            node = self.root
+            for part in [p for p in ref[2:-1].split('/') if p]:
+                node = node.child(part)
+            return node
+        label = ref[1:]
+        node = self.label_index.get(label)
+        if node is None:
+            node = self.refs.setdefault(label, Node(ref))
+        return node
+
+    def node(self, path):
+        node = self.root
+        for part in [p for p in path.split('/') if p]:
+            node = node.children.get(part)
+            if node is None:
+                return None
+        return node
+
+    def aliases(self):
+        """Map alias names to their target: a label for `&x`, else the path string."""
+        node = self.root.children.get('aliases')
+        if node is None:
+            return {}
+        result = {}
+        for name, values in node.props.items():
+            if values and values[0][0] == 'ref':
+                result[name] = values[0][1][1:].strip('{}')
+            elif values and values[0][0] == 'string':
+                result[name] = values[0][1][1:-1]
+        return result
+
+    def to_dict(self):
+        return {'root': self.root.to_dict(),
+                'refs': {k: v.to_dict() for k, v in self.refs.items()},
+                'missing_includes': self.missing_includes}
+
+    @classmethod
+    def from_dict(cls, d):
+        tree = cls()
+        tree.root = Node.from_dict(d['root'])
+        tree.refs = {k: Node.from_dict(v) for k, v in d['refs'].items()}
+        tree.missing_includes = list(d['missing_includes'])
+        # labels inside &unknown { ... } blocks live under refs
+        for top in [tree.root] + list(tree.refs.values()):
+            for node in top.walk():
+                for label in node.labels:
+                    tree.label_index[label] = node
+        return tree
+
+
+def tokenize(text, filename):
+    """Yield (kind, text, line) for every meaningful token."""
+    pos = 0
+    line = 1
+    while pos < len(text):
+        m = TOKEN.match(text, pos)
+        if not m:
+            raise DtsError(f'{filename}:{line}: unexpected {text[pos]!r}')
+        kind = m.lastgroup
+        if kind not in ('ws', 'comment'):
+            yield kind, m.group(), line
+        line += m.group().count('\n')
+        pos = m.end()
+
+
+class _Parser:
+    def __init__(self, tree, include_dirs):
+        self.tree = tree
+        self.include_dirs = [Path(d) for d in include_dirs]
+
+    def parse(self, path):
+        path = Path(path).resolve()
+        self.tree.includes.append(path)
+        self.run(path.read_text(), path)
+
+    def run(self, text, path, filename=None):
+        """Parse top-level statements, with their own token stream."""
+        saved = (getattr(self, 'tokens', None), getattr(self, 'pos', 0),
+                 getattr(self, 'path', None), getattr(self, 'filename', None))
+        self.filename = filename or path
+        self.tokens = list(tokenize(text, self.filename))
+        self.pos = 0
+        self.path = path
+
+        while self.pos < len(self.tokens):
+            kind, text, line = self.tokens[self.pos]
+            self.pos += 1
+            if kind == 'directive':
+                self.directive(text)
+            elif kind == 'keyword' and text == '/include/':
+                self.include(self.expect('string')[1:-1], quoted=True)
+            elif kind == 'keyword' and text == '/delete-node/':
+                ref = self.expect('ref')
+                self.expect('punct', ';')
+                self.tree.delete_ref(ref)
+            elif kind == 'keyword':
+                # /dts-v1/; /plugin/; /omit-if-no-ref/ ...
+                self.skip_statement()
+            elif kind == 'punct' and text == '/':
+                self.node_body(self.tree.root)
+            elif kind == 'ref':
+                self.node_body(self.tree.ref_target(text))
+            elif kind == 'label':
+                continue
+            else:
+                raise DtsError(f'{self.filename}:{line}: unexpected {text!r}')
+
+        self.tokens, self.pos, self.path, self.filename = saved
+
+    def directive(self, text):
+        m = INCLUDE.match(text)
+        if m:
+            self.include(m.group(2), quoted=m.group(1) == '"')
+
+    def include(self, name, quoted):
+        candidates = ([self.path.parent] if quoted and self.path else []) + self.include_dirs
+        for directory in candidates:
+            path = directory / name
+            if path.is_file():
+                self.parse(path)
+                return
+        self.tree.missing_includes.append(name)
+
+    def peek(self):
+        if self.pos >= len(self.tokens):
+            raise DtsError(f'{self.filename}: unexpected end of file')
+        return self.tokens[self.pos]
+
+    def expect(self, kind, text=None):
+        k, t, line = self.peek()
+        if k != kind or (text is not None and t != text):
+            raise DtsError(f'{self.filename}:{line}: expected {text or kind}, got {t!r}')
+        self.pos += 1
+        return t
+
+    def skip_statement(self):
+        while self.peek()[1] != ';':
+            self.pos += 1
+        self.pos += 1
+
+    def node_body(self, node):
+        """Parse `{ ... };` into `node`."""
+        self.expect('punct', '{')
+        while True:
+            kind, text, line = self.peek()
+            self.pos += 1
+
+            if kind == 'punct' and text == '}':
+                self.expect('punct', ';')
+                return
+            if kind == 'directive':
+                self.directive(text)
+                continue
+            if kind == 'keyword' and text == '/delete-node/':
+                name = self.peek()[1]
+                self.skip_statement()
+                self.tree.delete_node(node, name)
+                continue
+            if kind == 'keyword' and text == '/delete-property/':
+                name = self.peek()[1]
+                self.skip_statement()
+                node.props.pop(name, None)
+                continue
+
+            labels = []
+            while kind == 'label':
+                labels.append(text[:-1])
+                kind, text, line = self.peek()
+                self.pos += 1
+            if kind != 'name':
+                raise DtsError(f'{self.filename}:{line}: unexpected {text!r}')
+
+            k, t, _ = self.peek()
+            if t == '{':
+                # a node seen again is extended in place, as dtc does
+                child = node.child(text)
+                self.tree.add_labels(child, labels)
+                self.node_body(child)
+            elif t == ';':
+                self.pos += 1
+                node.props[text] = []
+            elif t == '=':
+                self.pos += 1
+                node.props[text] = self.values()
+            else:
+                raise DtsError(f'{self.filename}:{line}: expected {{, = or ; after {text!r}')
+
+    def values(self):
+        values = []
+        while True:
+            kind, text, line = self.peek()
+            self.pos += 1
+            if kind not in ('string', 'cells', 'bytes', 'ref'):
+                raise DtsError(f'{self.filename}:{line}: bad property value {text!r}')
+            values.append((kind, text))
+            kind, text, line = self.peek()
+            self.pos += 1
+            if text == ';':
+                return values
+            if text != ',':
+                raise DtsError(f'{self.filename}:{line}: expected , or ; got {text!r}')
+
+
+_memory_cache = {}
+
+
+def _digest(path):
+    return hashlib.sha256(Path(path).read_bytes()).hexdigest()
+
+
+def parse_file(path, include_dirs=(), cache_dir=None):
+    """Parse a DTS file, using the caches when its content is unchanged."""
+    path = Path(path).resolve()
+    digest = _digest(path)
+    key = (str(path), digest, tuple(str(d) for d in include_dirs))
+    if key in _memory_cache:
+        return _memory_cache[key]
+
+    entry = None
+    if cache_dir:
+        name = hashlib.sha256(repr(key).encode()).hexdigest()[:24] + '.json'
+        entry = Path(cache_dir) / name
+        tree = _load(entry)
+        if tree:
+            _memory_cache[key] = tree
+            return tree
+
+    tree = Tree()
+    _Parser(tree, include_dirs).parse(path)
+    _memory_cache[key] = tree
+
+    if entry:
+        _store(entry, tree)
+    return tree
+
+
+def parse_string(text, filename='<string>'):
+    """Parse DTS source from a string; includes are recorded, not followed."""
+    tree = Tree()
+    _Parser(tree, ()).run(text, None, filename)
+    return tree
+
+
+def _load(entry):
+    try:
+        data = json.loads(entry.read_text())
+    except (OSError, ValueError):
+        return None
+    if data.get('version') != CACHE_VERSION:
+        return None
+    for path, digest in data['includes']:
+        try:
+            if _digest(path) != digest:
+                return None
+        except OSError:
+            return None
+    tree = Tree.from_dict(data['tree'])
+    tree.includes = [Path(p) for p, _ in data['includes']]
+    return tree
+
+
+def _store(entry, tree):
+    data = {'version': CACHE_VERSION,
+            'includes': [(str(p), _digest(p)) for p in tree.includes],
+            'tree': tree.to_dict()}
+    entry.parent.mkdir(parents=True, exist_ok=True)
+    tmp = entry.with_suffix('.tmp')
+    tmp.write_text(json.dumps(data))
+    tmp.replace(entry)
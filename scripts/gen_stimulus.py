@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+"""Generate a button stimulus file for CONFIG_APP_STIMULUS replay.
+
+Writes <count> press/release cycles for one pin, optionally with contact
+bounce, using relative timestamps:
+
+    gen_stimulus.py presses.stim --count 5000 --pin 11 --period-us 60000 --bounce 3
+"""
+
+import argparse
+import random
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('output')
+    parser.add_argument('--count', type=int, default=100, help='presses (default: 100)')
+    parser.add_argument('--controller', type=int, default=0, help='gpio<N> (default: 0)')
+    parser.add_argument('--pin', type=int, default=11, help='pin (default: 11)')
+    parser.add_argument('--active-low', action='store_true', help='pressed = level 0')
+    parser.add_argument('--start-us', type=int, default=100000,
+                        help='time of the first press (default: 100000)')
+    parser.add_argument('--period-us', type=int, default=100000,
+                        help='press to press time (default: 100000)')
+    parser.add_argument('--bounce', type=int, default=0,
+                        help='extra bounce edge pairs per press and release (default: 0)')
+    parser.add_argument('--bounce-us', type=int, default=500,
+                        help='max gap between bounce edges (default: 500)')
+    parser.add_argument('--seed', type=int, default=1, help='RNG seed for bounce gaps')
+    args = parser.parse_args()
+
+    rng = random.Random(args.seed)
+    pressed = 0 if args.active_low else 1
+    released = 1 - pressed
+    half = args.period_us // 2
+
+    def burst(f, level, other, lead_us):
+        """One settled level change with bounce; returns the time it used."""
+        used = 0
+        f.write(f"+{lead_us} {args.controller} {args.pin} {level}\n")
+        for _ in range(args.bounce):
+            for lvl in (other, level):
+                gap = rng.randint(1, args.bounce_us)
+                used += gap
+                f.write(f"+{gap} {args.controller} {args.pin} {lvl}\n")
+        return used
+
+    with open(args.output, 'w') as f:
+        f.write(f"# {args.count} presses on gpio{args.controller} pin {args.pin}, "
+                f"generated by gen_stimulus.py\n")
+        lead = args.start_us
+        for _ in range(args.count):
+            used = burst(f, pressed, released, lead)
+            used = burst(f, released, pressed, max(half - used, 1))
+            lead = max(half - used, 1)
+
+
+if __name__ == '__main__':
+    main()
@@ -1,45 +1,47 @@
 #!/usr/bin/env python3
 
-import re
+import argparse
 import sys
 from pathlib import Path
 
-if len(sys.argv) != 2:
-    print("Usage: generate_overlay.py <student_overlay>")
-    sys.exit(1)
-
-student_overlay = Path(sys.argv[1]).resolve()
-
-# -------------------------------------------------
-# Always output to boards/native_sim.overlay
-# -------------------------------------------------
-app_root = Path.cwd()
-output_overlay = app_root / "boards" / "native_sim.overlay"
+import dts_parser
+
+# native_sim's gpio0 and every controller added here are 32-pin gpio-emul
+# ports; LEDs and buttons are packed from gpio0 FIRST_PIN upwards and spill
+# over into gpio1, gpio2, ... as needed. The stimulus replay and the gpio
+# trace address controllers by these gpio<n> labels, up to gpio7.
+PINS_PER_CONTROLLER = 32
+FIRST_PIN = 10
+
+parser = argparse.ArgumentParser(usage="generate_overlay.py <student_overlay> [options]")
+parser.add_argument('student_overlay')
+parser.add_argument('--output', default="boards/native_sim.overlay",
+                    help='overlay to write (default: boards/native_sim.overlay)')
+parser.add_argument('--leds', type=int, default=0,
+                    help='emit at least this many LEDs, padding after the aliased ones')
+parser.add_argument('--buttons', type=int, default=0,
+                    help='emit at least this many buttons, padding after the aliased ones')
+parser.add_argument('--cache-dir', help='keep parsed overlays here between runs')
+args = parser.parse_args()
+
+student_overlay = Path(args.student_overlay).resolve()
+output_overlay = Path(args.output)
 
 output_overlay.parent.mkdir(parents=True, exist_ok=True)
 
-text = student_overlay.read_text()
-
-# Extract aliases block
-aliases_block_match = re.search(
-    r'aliases\s*{([^}]*)};',
-    text,
-    re.DOTALL
-)
+try:
+    tree = dts_parser.parse_file(student_overlay, cache_dir=args.cache_dir)
+except dts_parser.DtsError as e:
+    print(f"Error: {e}")
+    sys.exit(1)
 
-if not aliases_block_match:
+if tree.root.children.get("aliases") is None:
     print("Error: no aliases block found")
     sys.exit(1)
 
-aliases_block = aliases_block_match.group(1)
-
-# Extract alias name + RHS target
-alias_pattern = re.compile(
-    r'^\s*(\w+)\s*=\s*&(\w+)\s*;',
-    re.MULTILINE
-)
-
-matches = alias_pattern.findall(aliases_block)
+# alias name + target label (a path target is classified by its last node)
+matches = [(alias, target.rstrip("/").split("/")[-1])
+           for alias, target in tree.aliases().items()]
 
 if not matches:
     print("Error: no aliases found")
@@ -57,63 +59,109 @@ for alias, target in matches:
     else:
         print(f"Warning: skipping unknown target '&{target}'")
 
+# (label, alias or None) for every node, aliased ones first
+leds = [(f"sim_{alias}", alias) for alias in led_aliases]
+leds += [(f"sim_led{i}", None) for i in range(len(leds), args.leds)]
+buttons = [(f"sim_{alias}", alias) for alias in button_aliases]
+buttons += [(f"sim_button{i}", None) for i in range(len(buttons), args.buttons)]
+
+
+def pins():
+    """Yield (controller, pin), gpio0 from FIRST_PIN, then whole controllers."""
+    controller, pin = 0, FIRST_PIN
+    while True:
+        yield controller, pin
+        pin += 1
+        if pin == PINS_PER_CONTROLLER:
+            controller, pin = controller + 1, 0
+
+
+def node_name(kind, controller, pin):
+    # gpio0 keeps the historical led_10, key_11, ... names
+    return f"{kind}_{pin}" if controller == 0 else f"{kind}_{controller}_{pin}"
+
+
+allocator = pins()
+last_controller = 0
+
 # Start overlay
 lines = []
 lines.append("/ {")
 lines.append("    aliases {")
 
-for alias in led_aliases + button_aliases:
-    lines.append(f"        {alias} = &sim_{alias};")
+for label, alias in leds + buttons:
+    if alias:
+        lines.append(f"        {alias} = &{label};")
 
 lines.append("    };")
 lines.append("")
 
-gpio_pin = 10
-
 # gpio-leds
-if led_aliases:
+if leds:
     lines.append("    sim_leds {")
     lines.append("        compatible = \"gpio-leds\";")
     lines.append("")
 
-    for alias in led_aliases:
-        lines.append(f"        sim_{alias}: led_{gpio_pin} {{")
-        lines.append(f"            gpios = <&gpio0 {gpio_pin} GPIO_ACTIVE_HIGH>;")
-        lines.append(f"            label = \"SIM_{alias.upper()}\";")
+    for label, alias in leds:
+        controller, pin = next(allocator)
+        last_controller = controller
+        lines.append(f"        {label}: {node_name('led', controller, pin)} {{")
+        lines.append(f"            gpios = <&gpio{controller} {pin} GPIO_ACTIVE_HIGH>;")
+        lines.append(f"            label = \"{label.upper()}\";")
         lines.append("        };")
         lines.append("")
-        gpio_pin += 1
 
     lines.append("    };")
     lines.append("")
 
 # gpio-keys
-if button_aliases:
+if buttons:
     lines.append("    sim_keys {")
     lines.append("        compatible = \"gpio-keys\";")
     lines.append("")
 
-    for alias in button_aliases:
-        lines.append(f"        sim_{alias}: key_{gpio_pin} {{")
-        lines.append(f"            gpios = <&gpio0 {gpio_pin} GPIO_ACTIVE_HIGH>;")
-        lines.append(f"            label = \"SIM_{alias.upper()}\";")
+    for label, alias in buttons:
+        controller, pin = next(allocator)
+        last_controller = controller
+        lines.append(f"        {label}: {node_name('key', controller, pin)} {{")
+        lines.append(f"            gpios = <&gpio{controller} {pin} GPIO_ACTIVE_HIGH>;")
+        lines.append(f"            label = \"{label.upper()}\";")
         lines.append("            zephyr,code = <1>; /* KEY_ESC */")
         lines.append("        };")
         lines.append("")
-        gpio_pin += 1
 
     lines.append("    };")
     lines.append("")
 
+# extra emulated controllers, same shape as native_sim's own gpio0
+for controller in range(1, last_controller + 1):
+    lines.append(f"    gpio{controller}: gpio_emul_{controller} {{")
+    lines.append("        status = \"okay\";")
+    lines.append("        compatible = \"zephyr,gpio-emul\";")
+    lines.append("        rising-edge;")
+    lines.append("        falling-edge;")
+    lines.append("        high-level;")
+    lines.append("        low-level;")
+    lines.append("        gpio-controller;")
+    lines.append("        #gpio-cells = <2>;")
+    lines.append(f"        ngpios = <{PINS_PER_CONTROLLER}>;")
+    lines.append("    };")
+    lines.append("")
+
 lines.append("};")
 lines.append("")
 lines.append("&gpio0 {")
 lines.append("    status = \"okay\";")
 lines.append("};")
 
-output_overlay.write_text("\n".join(lines))
+text = "\n".join(lines)
+
+# only rewrite on change, so an unchanged overlay does not retrigger dtc
+if not output_overlay.is_file() or output_overlay.read_text() != text:
+    output_overlay.write_text(text)
 
 print("Generated native_sim overlay:")
 print(f"  {output_overlay}")
-print(f"  LEDs: {', '.join(led_aliases) or 'none'}")
-print(f"  Buttons: {', '.join(button_aliases) or 'none'}")
+print(f"  LEDs: {len(leds)} ({', '.join(led_aliases) or 'no aliases'})")
+print(f"  Buttons: {len(buttons)} ({', '.join(button_aliases) or 'no aliases'})")
+print(f"  GPIO controllers: gpio0..gpio{last_controller}")
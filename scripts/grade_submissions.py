@@ -0,0 +1,399 @@
+#!/usr/bin/env python3
+"""Build and run many student submissions concurrently on native_sim.
+
+Every subdirectory of SUBMISSIONS is one submission: either the app itself
+(it has a CMakeLists.txt) or a checkout of this repo, in which case --app
+picks the app inside it. Only the app directory is taken from a submission;
+cmake/, common/ and scripts/ always come from this repo, so a submission
+cannot change the shared code that prints the RESULT line being graded.
+Each submission gets its own directory under --out:
+
+    <out>/<name>/tree/       the app staged into a repo-shaped tree next to
+                             this repo's cmake/, common/ and scripts/ (in
+                             the slot with --slot-cache)
+    <out>/<name>/build/      west build directory
+    <out>/<name>/build.log   west build output
+    <out>/<name>/run.log     simulator output (via run_sim.py)
+    <out>/<name>/check.log   waveform check output (with --waveform-pin)
+
+The simulator runs with <out>/<name> as its working directory, so the gpio
+traces of parallel runs do not overwrite each other.
+
+With --slot-cache, builds reuse a persistent build directory per Zephyr
+version and app configuration (see build_cache.py): only the submission's
+changed sources are recompiled and zephyr.exe is relinked against the
+kernel libraries already built there, and the executable is copied to
+<out>/<name>/zephyr.exe.
+
+With --result-cache, a submission whose inputs (app, cmake/, common/ and
+scripts/ trees, Zephyr version, build and run options, grader version)
+match an earlier run gets that run's verdict and artifacts back without
+building.
+Runs that timed out are not cached.
+
+Submissions are graded in parallel (--jobs, default: all cores), each build
+getting an equal share of the cores. Results are written as JSON and JUnit
+XML with per-phase timings.
+
+    west_workspace.py seed
+    grade_submissions.py submissions/ --app led_tests
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import shutil
+import subprocess
+import sys
+import time
+import xml.etree.ElementTree as ET
+from concurrent.futures import ThreadPoolExecutor, as_completed
+from pathlib import Path
+
+import build_cache
+import west_workspace
+
+SCRIPTS = Path(__file__).resolve().parent
+REPO = SCRIPTS.parent
+
+# the grader itself is an input of every verdict
+HARNESS = ('grade_submissions.py', 'build_cache.py', 'west_workspace.py', 'run_sim.py',
+           'check_waveform.py')
+
+# trees every app build reads besides the app itself, always this repo's
+SHARED_TREES = ('cmake', 'common', 'scripts')
+
+# run_sim.py exit status for a run that ended without a verdict
+RUN_SIM_TIMEOUT = 2
+LOG_TAIL_LINES = 40
+
+
+def find_submissions(root, app):
+    """Return {name: app source dir} for every submission under `root`."""
+    found = {}
+    for entry in sorted(Path(root).iterdir()):
+        if not entry.is_dir() or entry.name.startswith('.'):
+            continue
+        # a copy of the shared trees next to the submissions is not a student
+        if entry.name in SHARED_TREES and not (entry / 'CMakeLists.txt').is_file():
+            continue
+        src = entry if (entry / 'CMakeLists.txt').is_file() else entry / app
+        found[entry.name] = src
+    return found
+
+
+def tail(path, lines=LOG_TAIL_LINES):
+    try:
+        return ''.join(path.read_text(errors='replace').splitlines(True)[-lines:])
+    except OSError:
+        return ''
+
+
+def run_phase(result, phase, cmd, log, cwd, timeout, env=None):
+    """Run one phase, record its time and status; True if it passed."""
+    start = time.monotonic()
+    message = None
+    with open(log, 'w') as f:
+        f.write('$ ' + ' '.join(str(c) for c in cmd) + '\n')
+        f.flush()
+        try:
+            code = subprocess.run(cmd, cwd=cwd, stdout=f, stderr=subprocess.STDOUT,
+                                  stdin=subprocess.DEVNULL, timeout=timeout,
+                                  env=env).returncode
+        except subprocess.TimeoutExpired:
+            code = None
+            message = f'{phase} timed out'
+            f.write(f'\n{phase} timed out after {timeout:g} s\n')
+        except OSError as e:
+            # e.g. west or ninja not installed: this submission fails, the
+            # batch goes on
+            code = None
+            message = f'{phase} could not run: {e}'
+            f.write(f'\n{message}\n')
+
+    result['phases'][phase] = {'seconds': round(time.monotonic() - start, 3),
+                               'exit_code': code, 'log': str(log)}
+    if code == 0:
+        return True
+
+    fail(result, phase, message or f'{phase} exited with code {code}', tail(log))
+    return False
+
+
+def fail(result, phase, message, log_tail=''):
+    result['status'] = 'error' if phase in ('stage', 'build') else 'fail'
+    result['failed_phase'] = phase
+    result['message'] = message
+    result['log_tail'] = log_tail
+
+
+def stage(result, trees, dest):
+    """Sync the submission into a repo-shaped tree at `dest`; True if it worked.
+
+    The app's CMakeLists.txt reaches ../cmake, ../common and ../scripts, so
+    every build runs on such a tree, never on the submission directory.
+    """
+    start = time.monotonic()
+    try:
+        written, removed = build_cache.sync_tree(trees, dest)
+    except OSError as e:
+        fail(result, 'stage', f'staging the submission failed: {e}')
+        return False
+    result['phases']['stage'] = {'seconds': round(time.monotonic() - start, 3),
+                                 'files_written': written,
+                                 'files_removed': removed}
+    return True
+
+
+def app_trees(src, app):
+    """The directories an app build reads: the submitted app, and this
+    repo's cmake/, common/ and scripts/, whatever the submission holds."""
+    trees = {app: src}
+    for shared in SHARED_TREES:
+        trees[shared] = REPO / shared
+    return trees
+
+
+def build_in_slot(result, name, src, args, build_jobs, out):
+    """Build in a shared slot, then copy zephyr.exe out; True if it passed."""
+    trees = app_trees(src.resolve(), args.app)
+    key = build_cache.config_key(trees, args.workspace, [args.board] + args.cmake_args)
+
+    with build_cache.acquire_slot(args.slot_cache, key) as slot:
+        result['slot'] = {'key': key, 'path': str(slot)}
+        if not stage(result, trees, slot / 'tree'):
+            return False
+
+        build = ['west', 'build', '-b', args.board, '-s', str(slot / 'tree' / args.app),
+                 '-d', str(slot / 'build'), f'-o=-j{build_jobs}']
+        if args.cmake_args:
+            build += ['--'] + args.cmake_args
+
+        if not run_phase(result, 'build', build, out / 'build.log', args.workspace,
+                         args.build_timeout):
+            return False
+        try:
+            shutil.copy2(slot / 'build' / 'zephyr' / 'zephyr.exe', out / 'zephyr.exe')
+        except OSError as e:
+            fail(result, 'build', f'no zephyr.exe after the build: {e}')
+            return False
+    return True
+
+
+def harness_version():
+    h = hashlib.sha256()
+    for script in HARNESS:
+        h.update((SCRIPTS / script).read_bytes())
+    return h.hexdigest()
+
+
+def build_and_run(result, name, src, args, build_jobs, out):
+    build_dir = out / 'build'
+
+    if args.slot_cache:
+        ok = build_in_slot(result, name, src, args, build_jobs, out)
+        exe = out / 'zephyr.exe'
+    else:
+        ok = stage(result, app_trees(src.resolve(), args.app), out / 'tree')
+        if ok:
+            build = ['west', 'build', '-b', args.board, '-s', str(out / 'tree' / args.app),
+                     '-d', str(build_dir), f'-o=-j{build_jobs}']
+            if args.pristine:
+                build += ['-p', 'always']
+            if args.cmake_args:
+                build += ['--'] + args.cmake_args
+
+            ok = run_phase(result, 'build', build, out / 'build.log', args.workspace,
+                           args.build_timeout)
+        exe = build_dir / 'zephyr' / 'zephyr.exe'
+
+    if ok:
+        run = [sys.executable, str(SCRIPTS / 'run_sim.py'), '--quiet',
+               '--timeout', str(args.run_timeout)]
+        for pattern in args.expect:
+            run += ['--expect', pattern]
+        run += ['--', str(exe)] + args.sim_args
+        # run_sim.py enforces --run-timeout itself; the extra margin only
+        # covers a harness that hangs
+        ok = run_phase(result, 'run', run, out / 'run.log', out, args.run_timeout + 30)
+
+    if ok and args.waveform_pin is not None:
+        check = [sys.executable, str(SCRIPTS / 'check_waveform.py'),
+                 str(out / 'gpio_trace.bin'), '--pin', str(args.waveform_pin),
+                 '--interval-ms', str(args.interval_ms)]
+        run_phase(result, 'check', check, out / 'check.log', out, 300)
+
+
+def cacheable(result):
+    """Timeouts depend on the machine's load, not only on the inputs."""
+    phases = result['phases']
+    if any(p.get('exit_code', 0) is None for p in phases.values()):
+        return False
+    return phases.get('run', {}).get('exit_code') != RUN_SIM_TIMEOUT
+
+
+def grade(name, src, args, build_jobs):
+    out = (Path(args.out) / name).resolve()
+    out.mkdir(parents=True, exist_ok=True)
+    # drop the artifacts of an earlier grading, the build directory stays
+    for path in out.iterdir():
+        if path.is_file():
+            path.unlink()
+
+    result = {'name': name, 'source': str(src), 'status': 'pass', 'phases': {}}
+    start = time.monotonic()
+
+    if not (src / 'CMakeLists.txt').is_file():
+        result.update(status='error', failed_phase='build',
+                      message=f'no CMakeLists.txt in {src}')
+        result['seconds'] = 0.0
+        return result
+
+    key = None
+    if args.result_cache:
+        options = [harness_version(), args.board, args.cmake_args, args.sim_args,
+                   args.expect, args.run_timeout, args.waveform_pin, args.interval_ms]
+        key = build_cache.input_key(app_trees(src.resolve(), args.app), args.workspace,
+                                    options)
+        cached = build_cache.load_result(args.result_cache, key, out)
+        if cached:
+            cached.update(name=name, source=str(src), cached=True,
+                          seconds=round(time.monotonic() - start, 3))
+            return cached
+
+    build_and_run(result, name, src, args, build_jobs, out)
+    result['seconds'] = round(time.monotonic() - start, 3)
+
+    if key and cacheable(result):
+        result['input_key'] = key
+        build_cache.store_result(args.result_cache, key, result, out)
+    return result
+
+
+def write_junit(path, app, results, seconds):
+    failures = sum(r['status'] == 'fail' for r in results)
+    errors = sum(r['status'] == 'error' for r in results)
+
+    suite = ET.Element('testsuite', name=app, tests=str(len(results)),
+                       failures=str(failures), errors=str(errors), time=f'{seconds:.3f}')
+    for r in results:
+        case = ET.SubElement(suite, 'testcase', classname=app, name=r['name'],
+                             time=f"{r['seconds']:.3f}")
+        props = ET.SubElement(case, 'properties')
+        if r.get('cached'):
+            ET.SubElement(props, 'property', name='cached', value='true')
+        if 'slot' in r:
+            ET.SubElement(props, 'property', name='slot_key', value=r['slot']['key'])
+        for phase, p in r['phases'].items():
+            ET.SubElement(props, 'property', name=f'{phase}_seconds',
+                          value=f"{p['seconds']:.3f}")
+        if r['status'] != 'pass':
+            tag = 'failure' if r['status'] == 'fail' else 'error'
+            node = ET.SubElement(case, tag, message=r['message'],
+                                 type=r.get('failed_phase', ''))
+            node.text = r.get('log_tail', '')
+
+    ET.indent(suite)
+    ET.ElementTree(suite).write(path, encoding='utf-8', xml_declaration=True)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('submissions', help='directory with one subdirectory per submission')
+    parser.add_argument('--app', default='led_tests',
+                        help='app directory inside a repo checkout (default: led_tests)')
+    parser.add_argument('--workspace', default=west_workspace.default_workspace(),
+                        help='west workspace to build in (default: the shared workspace of '
+                             'west_workspace.py, $BME_WEST_WORKSPACE or ~/.cache/bme/west-workspace)')
+    parser.add_argument('--out', default='grading', help='output directory (default: grading)')
+    parser.add_argument('--jobs', type=int, default=os.cpu_count(),
+                        help='submissions graded at once (default: all cores)')
+    parser.add_argument('--board', default='native_sim')
+    parser.add_argument('--pristine', action='store_true', help='always build from scratch')
+    parser.add_argument('--slot-cache', metavar='DIR',
+                        help='reuse kernel builds across submissions with the same '
+                             'configuration (see build_cache.py)')
+    parser.add_argument('--cmake-arg', dest='cmake_args', action='append', default=[],
+                        help='extra CMake argument (repeatable, e.g. --cmake-arg=-DFOO=1)')
+    parser.add_argument('--result-cache', metavar='DIR',
+                        help='reuse verdicts of submissions with identical inputs')
+    parser.add_argument('--build-timeout', type=float, default=1800)
+    parser.add_argument('--run-timeout', type=float, default=60)
+    parser.add_argument('--sim-arg', dest='sim_args', action='append', default=[],
+                        help='argument for zephyr.exe (repeatable, e.g. --sim-arg=--stop_at=30)')
+    parser.add_argument('--expect', action='append', default=[], metavar='REGEX',
+                        help='pattern the run output must contain (repeatable)')
+    parser.add_argument('--waveform-pin', type=int,
+                        help='also check the gpio0 waveform of this pin')
+    parser.add_argument('--interval-ms', type=float, default=500,
+                        help='toggle interval for the waveform check (default: 500)')
+    args = parser.parse_args()
+
+    if not west_workspace.is_seeded(Path(args.workspace)):
+        print(f"Error: {args.workspace} is not a west workspace, "
+              f"run 'west_workspace.py seed' first", file=sys.stderr)
+        return 2
+
+    submissions = find_submissions(args.submissions, args.app)
+    if not submissions:
+        print(f"Error: no submissions in {args.submissions}", file=sys.stderr)
+        return 2
+
+    jobs = max(1, min(args.jobs, len(submissions)))
+    build_jobs = max(1, (os.cpu_count() or 1) // jobs)
+    Path(args.out).mkdir(parents=True, exist_ok=True)
+
+    print(f"Grading {len(submissions)} submissions, {jobs} at a time, "
+          f"{build_jobs} build jobs each")
+
+    start = time.monotonic()
+    results = []
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        futures = {pool.submit(grade, name, src, args, build_jobs): name
+                   for name, src in submissions.items()}
+        for future in as_completed(futures):
+            name = futures[future]
+            try:
+                r = future.result()
+            except Exception as e:
+                # a grader bug must not take the rest of the batch down
+                r = {'name': name, 'source': str(submissions[name]), 'phases': {},
+                     'seconds': 0.0}
+                fail(r, 'stage', f'grading crashed: {e!r}')
+            results.append(r)
+            phases = ' '.join(f"{k}={v['seconds']:.1f}s" for k, v in r['phases'].items())
+            if r.get('cached'):
+                phases = 'cached'
+            print(f"  {r['status'].upper():5} {r['name']} {phases}"
+                  + (f" ({r['message']})" if r['status'] != 'pass' else ''))
+    seconds = time.monotonic() - start
+
+    results.sort(key=lambda r: r['name'])
+    summary = {
+        'app': args.app,
+        'seconds': round(seconds, 3),
+        'jobs': jobs,
+        'total': len(results),
+        'passed': sum(r['status'] == 'pass' for r in results),
+        'failed': sum(r['status'] == 'fail' for r in results),
+        'errors': sum(r['status'] == 'error' for r in results),
+        'cached': sum(bool(r.get('cached')) for r in results),
+        'submissions': results,
+    }
+
+    out = Path(args.out)
+    (out / 'results.json').write_text(json.dumps(summary, indent=2) + '\n')
+    write_junit(out / 'junit.xml', args.app, results, seconds)
+
+    print(f"GRADING total={summary['total']} passed={summary['passed']} "
+          f"failed={summary['failed']} errors={summary['errors']} cached={summary['cached']} "
+          f"elapsed_s={seconds:.1f}")
+    print(f"Results in {out / 'results.json'} and {out / 'junit.xml'}")
+
+    return 0 if summary['passed'] == summary['total'] else 1
+
+
+if __name__ == '__main__':
+    sys.exit(main())
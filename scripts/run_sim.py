@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""Run a native_sim executable and stop it as soon as the verdict is known.
+
+Output is streamed line by line (and copied to --log). The run ends as soon
+as one of these happens:
+
+  * the firmware prints "RESULT PASS" / "RESULT FAIL" (see app_exit.h) and
+    exits, or is stopped after a short grace period if it does not
+  * a --fail pattern matches                                   -> FAIL
+  * every --expect pattern has matched (with --stop-on-expect) -> PASS
+  * the process exits on its own                 -> its exit code decides
+  * --timeout wall-clock seconds pass                          -> TIMEOUT
+
+The simulation is stopped with SIGTERM, which native_sim handles by running
+its exit hooks (e.g. the gpio trace flush), then SIGKILL if it lingers.
+
+    run_sim.py --log out.log --expect "LED ON" -- build/zephyr/zephyr.exe --stop_at=30
+
+Exit status: 0 pass, 1 fail, 2 timeout.
+"""
+
+import argparse
+import os
+import re
+import signal
+import subprocess
+import sys
+import threading
+import time
+
+# app_exit.h verdict, a broken stimulus replay (stimulus.h) and the ztest
+# summary of the apps under tests/
+DEFAULT_FAIL = [r'^RESULT FAIL', r'^STIMULUS error=', r'^PROJECT EXECUTION FAILED']
+RESULT = re.compile(r'^RESULT (PASS|FAIL)')
+
+# time the firmware gets to exit by itself after printing its RESULT line
+RESULT_GRACE_S = 2.0
+TERM_GRACE_S = 2.0
+
+
+def stop(proc):
+    """SIGTERM the run's process group, SIGKILL it if it does not go away."""
+    if proc.poll() is not None:
+        return
+    try:
+        os.killpg(proc.pid, signal.SIGTERM)
+        proc.wait(TERM_GRACE_S)
+    except subprocess.TimeoutExpired:
+        os.killpg(proc.pid, signal.SIGKILL)
+        proc.wait()
+    except ProcessLookupError:
+        pass
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--timeout', type=float, default=60,
+                        help='wall-clock limit in seconds (default: 60)')
+    parser.add_argument('--expect', action='append', default=[], metavar='REGEX',
+                        help='pattern that must appear (repeatable)')
+    parser.add_argument('--fail', action='append', default=[], metavar='REGEX',
+                        help='pattern that fails the run at once (repeatable, added to '
+                             'the defaults: %s)' % ', '.join(DEFAULT_FAIL))
+    parser.add_argument('--stop-on-expect', action='store_true',
+                        help='pass and stop as soon as every --expect has matched')
+    parser.add_argument('--log', help='copy the output to this file')
+    parser.add_argument('--quiet', action='store_true', help='do not echo the output')
+    parser.add_argument('command', nargs=argparse.REMAINDER,
+                        help='-- executable [args...]')
+    args = parser.parse_args()
+
+    command = args.command[1:] if args.command[:1] == ['--'] else args.command
+    if not command:
+        parser.error('no command given')
+
+    expects = {pattern: re.compile(pattern) for pattern in args.expect}
+    fails = [re.compile(p) for p in DEFAULT_FAIL + args.fail]
+    pending = set(expects)
+
+    start = time.monotonic()
+    proc = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                            stdin=subprocess.DEVNULL, text=True, errors='replace', bufsize=1,
+                            start_new_session=True)
+
+    timed_out = threading.Event()
+
+    def watchdog():
+        timed_out.set()
+        stop(proc)
+
+    timer = threading.Timer(args.timeout, watchdog)
+    timer.daemon = True
+    timer.start()
+
+    log = open(args.log, 'w') if args.log else None
+    verdict = None
+    reason = None
+
+    try:
+        for line in proc.stdout:
+            if log:
+                log.write(line)
+                log.flush()
+            if not args.quiet:
+                sys.stdout.write(line)
+                sys.stdout.flush()
+
+            line = line.rstrip('\n')
+
+            for regex in fails:
+                if regex.search(line):
+                    verdict, reason = 'FAIL', f'matched fail pattern {regex.pattern!r}'
+                    break
+            if verdict:
+                break
+
+            for pattern in list(pending):
+                if expects[pattern].search(line):
+                    pending.discard(pattern)
+
+            m = RESULT.match(line)
+            if m:
+                verdict, reason = m.group(1), 'firmware reported result'
+                break
+
+            if args.stop_on_expect and expects and not pending:
+                verdict, reason = 'PASS', 'all expectations met'
+                break
+
+        if reason == 'firmware reported result':
+            # let the firmware exit by itself so its exit hooks run, then
+            # keep whatever it printed on the way out
+            try:
+                proc.wait(RESULT_GRACE_S)
+            except subprocess.TimeoutExpired:
+                stop(proc)
+            for line in proc.stdout:
+                if log:
+                    log.write(line)
+                if not args.quiet:
+                    sys.stdout.write(line)
+    finally:
+        stop(proc)
+        timer.cancel()
+        if log:
+            log.close()
+
+    if timed_out.is_set() and verdict is None:
+        verdict, reason = 'TIMEOUT', f'no verdict within {args.timeout:g} s'
+    elif verdict is None:
+        code = proc.returncode
+        verdict = 'PASS' if code == 0 else 'FAIL'
+        reason = f'exited with code {code}'
+
+    if verdict == 'PASS' and pending:
+        verdict = 'FAIL'
+        reason = 'missing expected output: ' + ', '.join(repr(p) for p in sorted(pending))
+    elif verdict == 'PASS' and proc.returncode > 0:
+        verdict, reason = 'FAIL', f'reported PASS but exited with code {proc.returncode}'
+
+    elapsed = time.monotonic() - start
+    print(f"HARNESS verdict={verdict} elapsed_s={elapsed:.3f} reason={reason}")
+
+    return {'PASS': 0, 'FAIL': 1, 'TIMEOUT': 2}[verdict]
+
+
+if __name__ == '__main__':
+    sys.exit(main())
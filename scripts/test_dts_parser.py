@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Tests for dts_parser.py: python3 -m unittest discover -s scripts"""
+
+import tempfile
+import unittest
+from pathlib import Path
+
+import dts_parser
+
+OVERLAY = '''
+/ {
+    aliases {
+        ledtest = &led0;
+        buttontest = &btn;
+    };
+
+    leds {
+        compatible = "gpio-leds";
+        led0: led_0 { gpios = <&gpio0 10 0>; };
+        led1: led_1 { inner: sub { }; };
+    };
+};
+
+&gpio0 {
+    btn: button_0 { gpios = <&gpio0 11 0>; };
+};
+
+&led0 { label = "LED0"; };
+'''
+
+
+class LabelIndexTest(unittest.TestCase):
+    def test_labels(self):
+        tree = dts_parser.parse_string(OVERLAY)
+        self.assertEqual(sorted(tree.labels()), ['btn', 'inner', 'led0', 'led1'])
+        self.assertIn('label', tree.node('/leds/led_0').props)
+
+    def test_delete_drops_subtree_labels(self):
+        tree = dts_parser.parse_string(OVERLAY + '/delete-node/ &led1;\n&inner { x; };\n')
+        self.assertNotIn('led1', tree.labels())
+        self.assertNotIn('inner', tree.labels())
+        self.assertIsNone(tree.node('/leds/led_1'))
+        # the label is gone, so &inner is a reference into the base tree
+        self.assertIn('inner', tree.refs)
+
+    def test_cache_round_trip(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = Path(tmp) / 'app.overlay'
+            path.write_text(OVERLAY)
+            cache = Path(tmp) / 'cache'
+
+            first = dts_parser.parse_file(path, cache_dir=cache)
+            dts_parser._memory_cache.clear()
+            second = dts_parser.parse_file(path, cache_dir=cache)
+
+            self.assertIsNot(first, second)
+            self.assertEqual(sorted(second.labels()), sorted(first.labels()))
+            self.assertEqual(second.to_dict(), first.to_dict())
+            # labels defined under &gpio0 { ... } survive the reload
+            self.assertEqual(second.labels()['btn'].name, 'button_0')
+            self.assertEqual(second.labels()['led0'].parent.name, 'leds')
+
+
+class PathReferenceTest(unittest.TestCase):
+    def test_extend_by_path(self):
+        tree = dts_parser.parse_string(OVERLAY + '&{/leds/led_1} { label = "LED1"; };\n')
+        self.assertIn('label', tree.node('/leds/led_1').props)
+        self.assertEqual(tree.refs.keys(), {'gpio0'})
+
+    def test_base_tree_path_is_created(self):
+        tree = dts_parser.parse_string('&{/soc/gpio@0} { status = "okay"; };\n')
+        self.assertIn('status', tree.node('/soc/gpio@0').props)
+
+    def test_delete_by_path(self):
+        tree = dts_parser.parse_string(OVERLAY + '/delete-node/ &{/leds/led_1};\n')
+        self.assertIsNone(tree.node('/leds/led_1'))
+        self.assertNotIn('inner', tree.labels())
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+"""Manage the shared west workspace the apps are built in.
+
+Instead of running `west init` and `west update` inside every app checkout,
+one workspace is seeded once and shared by every build, CI run and grading
+job. After seeding, building needs no network at all.
+
+    west_workspace.py seed                 # fetch Zephyr (needs network once)
+    west_workspace.py pack ws.tar.gz       # snapshot it for offline machines
+    west_workspace.py seed --from ws.tar.gz  # seed from the snapshot, offline
+    west_workspace.py build led_tests      # west build inside the workspace
+    eval "$(west_workspace.py env)"        # export ZEPHYR_BASE for other tools
+
+The workspace is --workspace, else $BME_WEST_WORKSPACE, else
+~/.cache/bme/west-workspace. native_sim needs no Zephyr modules, so by
+default only the zephyr repository is fetched; --module adds modules.
+
+Zephyr is pinned to a release tag (DEFAULT_REVISION), so every seed and
+every CI cache entry, which is keyed on this file, builds against the same
+tree. The seeded revision is recorded in the workspace; seeding a workspace
+that holds another one fails unless --update moves it to the new tag.
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+import tarfile
+from pathlib import Path
+
+DEFAULT_MANIFEST = 'https://github.com/zephyrproject-rtos/zephyr'
+# a release tag, never a branch: a branch would give a different Zephyr on
+# every fresh seed while cached workspaces keep an old one
+DEFAULT_REVISION = 'v4.1.0'
+ENV = 'BME_WEST_WORKSPACE'
+REVISION_FILE = '.bme-revision'
+
+
+def default_workspace():
+    return os.environ.get(ENV) or str(Path.home() / '.cache' / 'bme' / 'west-workspace')
+
+
+def is_seeded(ws):
+    return (ws / '.west' / 'config').is_file() and (ws / 'zephyr' / 'VERSION').is_file()
+
+
+def seeded_revision(ws):
+    try:
+        return (ws / REVISION_FILE).read_text().strip()
+    except OSError:
+        return None
+
+
+def west(ws, *args):
+    print('$ west ' + ' '.join(args), flush=True)
+    subprocess.run(['west', *args], cwd=ws, check=True)
+
+
+def seed(args):
+    ws = Path(args.workspace)
+    if is_seeded(ws) and not args.update:
+        current = seeded_revision(ws)
+        if current == args.revision:
+            print(f"{ws} is already seeded ({current})")
+            return 0
+        print(f"Error: {ws} holds Zephyr {current or 'of an unknown revision'}, "
+              f"not {args.revision}; re-run with --update", file=sys.stderr)
+        return 1
+
+    if args.from_archive:
+        ws.mkdir(parents=True, exist_ok=True)
+        with tarfile.open(args.from_archive) as tar:
+            try:
+                tar.extractall(ws, filter='tar')
+            except TypeError:
+                # Python without extraction filters (< 3.10.12)
+                tar.extractall(ws)
+        if not is_seeded(ws):
+            print(f"Error: {args.from_archive} does not hold a west workspace", file=sys.stderr)
+            return 1
+        print(f"Seeded {ws} from {args.from_archive}")
+        return 0
+
+    if not (ws / '.west').is_dir():
+        ws.mkdir(parents=True, exist_ok=True)
+        west(ws, 'init', '-m', args.manifest, '--mr', args.revision, str(ws))
+    elif seeded_revision(ws) != args.revision:
+        # move the manifest repository (zephyr) to the requested tag
+        zephyr = str(ws / 'zephyr')
+        subprocess.run(['git', '-C', zephyr, 'fetch', '--depth=1', 'origin', args.revision],
+                       check=True)
+        subprocess.run(['git', '-C', zephyr, 'checkout', '--detach', 'FETCH_HEAD'], check=True)
+
+    # only the manifest repository (zephyr) plus the requested modules
+    west(ws, 'config', 'manifest.project-filter', '--',
+         ','.join(['-.*'] + [f'+{m}' for m in args.module]))
+    west(ws, 'update', '--narrow', '-o=--depth=1')
+    (ws / REVISION_FILE).write_text(args.revision + '\n')
+    print(f"Seeded {ws} with Zephyr {args.revision}")
+    return 0
+
+
+def pack(args):
+    ws = Path(args.workspace)
+    if not is_seeded(ws):
+        print(f"Error: {ws} is not seeded", file=sys.stderr)
+        return 1
+    with tarfile.open(args.archive, 'w:gz') as tar:
+        for entry in sorted(ws.iterdir()):
+            tar.add(entry, arcname=entry.name)
+    print(f"Packed {ws} into {args.archive}")
+    return 0
+
+
+def build(args):
+    ws = Path(args.workspace)
+    if not is_seeded(ws):
+        print(f"Error: {ws} is not seeded, run '{sys.argv[0]} seed' first", file=sys.stderr)
+        return 1
+    app = Path(args.app).resolve()
+    build_dir = Path(args.build_dir).resolve() if args.build_dir else app / 'build'
+    cmd = ['west', 'build', '-b', args.board, '-s', str(app), '-d', str(build_dir)]
+    if args.pristine:
+        cmd += ['-p', 'always']
+    if args.cmake_args:
+        cmd += ['--'] + args.cmake_args
+    return subprocess.run(cmd, cwd=ws).returncode
+
+
+def env(args):
+    ws = Path(args.workspace).resolve()
+    print(f"export {ENV}={ws}")
+    print(f"export ZEPHYR_BASE={ws / 'zephyr'}")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--workspace', default=default_workspace(),
+                        help=f'workspace directory (default: ${ENV} or ~/.cache/bme/west-workspace)')
+    sub = parser.add_subparsers(dest='command', required=True)
+
+    p = sub.add_parser('seed', help='create the workspace (no-op if it exists)')
+    p.add_argument('--from', dest='from_archive', metavar='ARCHIVE',
+                   help='unpack a workspace made by "pack" instead of fetching')
+    p.add_argument('--manifest', default=DEFAULT_MANIFEST)
+    p.add_argument('--revision', default=DEFAULT_REVISION,
+                   help=f'Zephyr tag to check out (default: {DEFAULT_REVISION})')
+    p.add_argument('--module', action='append', default=[],
+                   help='Zephyr module to fetch as well (repeatable)')
+    p.add_argument('--update', action='store_true', help='update an existing workspace')
+    p.set_defaults(func=seed)
+
+    p = sub.add_parser('pack', help='write the workspace to a .tar.gz')
+    p.add_argument('archive')
+    p.set_defaults(func=pack)
+
+    p = sub.add_parser('build', help='west build an app in the workspace')
+    p.add_argument('app', help='app directory, e.g. led_tests')
+    p.add_argument('-b', '--board', default='native_sim')
+    p.add_argument('-d', '--build-dir', help='default: <app>/build')
+    p.add_argument('-p', '--pristine', action='store_true')
+    p.add_argument('cmake_args', nargs=argparse.REMAINDER, help='-- extra CMake arguments')
+    p.set_defaults(func=build)
+
+    p = sub.add_parser('env', help='print shell exports for the workspace')
+    p.set_defaults(func=env)
+
+    args = parser.parse_args()
+    if getattr(args, 'cmake_args', None) and args.cmake_args[0] == '--':
+        args.cmake_args = args.cmake_args[1:]
+    return args.func(args)
+
+
+if __name__ == '__main__':
+    sys.exit(main())
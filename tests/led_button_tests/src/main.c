@@ -0,0 +1,131 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+
+#include "button_queue.h"
+#include "debounce.h"
+
+// hold each level past the debounce window so every press is accepted
+#define HOLD_MS (CONFIG_APP_DEBOUNCE_MS + 10)
+
+static const struct gpio_dt_spec button = GPIO_DT_SPEC_GET(DT_ALIAS(buttontest), gpios);
+static struct gpio_callback button_cb;
+
+static void button_callback(const struct device *dev, struct gpio_callback *cb, uint32_t pins)
+{
+    ARG_UNUSED(dev);
+    ARG_UNUSED(cb);
+    debounce_edge(pins);
+}
+
+// drives the emulated pin to a logical level, honouring GPIO_ACTIVE_LOW
+static void button_set(int pressed)
+{
+    int level = (button.dt_flags & GPIO_ACTIVE_LOW) ? !pressed : pressed;
+
+    zassert_ok(gpio_emul_input_set(button.port, button.pin, level));
+}
+
+static void queue_drain(void)
+{
+    struct button_event evt;
+
+    while (button_queue_get(&evt, K_NO_WAIT) == 0) {
+    }
+}
+
+// the app's init() in miniature: input, debouncer, both-edge interrupt
+static void *debounce_setup(void)
+{
+    zassert_true(device_is_ready(button.port));
+    zassert_ok(gpio_pin_configure_dt(&button, GPIO_INPUT));
+    button_set(0);
+    zassert_ok(debounce_init(&button));
+    zassert_ok(gpio_pin_interrupt_configure_dt(&button, GPIO_INT_EDGE_BOTH));
+    gpio_init_callback(&button_cb, button_callback, BIT(button.pin));
+    zassert_ok(gpio_add_callback_dt(&button, &button_cb));
+    return NULL;
+}
+
+// every test starts released, with an empty queue
+static void debounce_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    button_set(0);
+    k_msleep(HOLD_MS);
+    queue_drain();
+}
+
+static void expect_event(uint8_t edge)
+{
+    struct button_event evt;
+
+    zassert_ok(button_queue_get(&evt, K_NO_WAIT), "no %s queued",
+               edge == BUTTON_EDGE_PRESS ? "press" : "release");
+    zassert_equal(evt.edge, edge);
+    zassert_equal(evt.pins, BIT(button.pin));
+}
+
+static void expect_empty(void)
+{
+    struct button_event evt;
+
+    zassert_not_ok(button_queue_get(&evt, K_NO_WAIT), "unexpected event queued");
+}
+
+ZTEST(debounce, test_press_and_release)
+{
+    button_set(1);
+    k_msleep(HOLD_MS);
+    expect_event(BUTTON_EDGE_PRESS);
+    expect_empty();
+
+    button_set(0);
+    k_msleep(HOLD_MS);
+    expect_event(BUTTON_EDGE_RELEASE);
+    expect_empty();
+
+    zassert_equal(button_queue_dropped(), 0);
+}
+
+ZTEST(debounce, test_bounce_is_one_press)
+{
+    // five edges 1 ms apart, all inside the window, ending pressed
+    for (int i = 0; i < 5; i++) {
+        button_set(i % 2 == 0);
+        k_msleep(1);
+    }
+    k_msleep(HOLD_MS);
+    expect_event(BUTTON_EDGE_PRESS);
+    expect_empty();
+}
+
+ZTEST(debounce, test_bounce_back_is_nothing)
+{
+    // a glitch that returns to the released level before the window ends
+    button_set(1);
+    k_msleep(1);
+    button_set(0);
+    k_msleep(HOLD_MS);
+    expect_empty();
+}
+
+// the event carries the interrupt time of the first edge and, one window
+// later, the time the debouncer accepted it
+ZTEST(debounce, test_press_timestamps)
+{
+    struct button_event evt;
+    uint64_t window = k_ms_to_cyc_floor64(CONFIG_APP_DEBOUNCE_MS);
+    uint64_t edge = button_cycles();
+
+    button_set(1);
+    k_msleep(HOLD_MS);
+    zassert_ok(button_queue_get(&evt, K_NO_WAIT));
+    zassert_true(button_cycles_between(edge, evt.cycles) < window,
+                 "press not stamped at its first edge");
+    zassert_true(button_cycles_between(evt.cycles, evt.accepted_cycles) >= window,
+                 "press accepted before the settle window ended");
+}
+
+ZTEST_SUITE(debounce, NULL, debounce_setup, debounce_before, NULL, NULL);
@@ -0,0 +1,120 @@
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/logging/log.h>
+
+#include "leds.h"
+#include "patterns.h"
+#include "sequencer.h"
+
+// leds.c logs to the app's main module, which lives in the app's main.c
+LOG_MODULE_REGISTER(main, LOG_LEVEL_DBG);
+
+#define LED_SPEC(node) GPIO_DT_SPEC_GET(node, gpios),
+
+static const struct gpio_dt_spec leds[] = {
+    DT_FOREACH_CHILD(LEDS_NODE, LED_SPEC)
+};
+
+// Logical frame read back from the GPIO emulator's output levels, i.e. what
+// the pins actually show rather than what leds_update() was asked for.
+static uint32_t leds_readback(void)
+{
+    uint32_t frame = 0;
+
+    for (size_t i = 0; i < ARRAY_SIZE(leds); i++) {
+        int level = gpio_emul_output_get(leds[i].port, leds[i].pin);
+        bool active_low = (leds[i].dt_flags & GPIO_ACTIVE_LOW) != 0;
+
+        zassert_true(level >= 0, "cannot read LED %u back", (unsigned int)i);
+        if ((level != 0) != active_low) {
+            frame |= BIT(i);
+        }
+    }
+
+    return frame;
+}
+
+static void *leds_setup(void)
+{
+    zassert_ok(leds_init());
+    zassert_equal(leds_readback(), 0, "LEDs not off after init");
+    return NULL;
+}
+
+static void leds_before(void *fixture)
+{
+    ARG_UNUSED(fixture);
+    leds_write(0);
+}
+
+ZTEST(leds, test_write)
+{
+    uint32_t frames[] = { LEDS_ALL, 0, 0x55555555U & LEDS_ALL, 0xaaaaaaaaU & LEDS_ALL };
+
+    for (size_t i = 0; i < ARRAY_SIZE(frames); i++) {
+        zassert_ok(leds_write(frames[i]));
+        zassert_equal(leds_readback(), frames[i], "pins differ from frame 0x%x", frames[i]);
+        zassert_equal(leds_get(), frames[i]);
+    }
+
+    for (size_t i = 0; i < LEDS_COUNT; i++) {
+        zassert_ok(leds_write(BIT(i)));
+        zassert_equal(leds_readback(), BIT(i), "LED %u alone is not lit", (unsigned int)i);
+    }
+}
+
+ZTEST(leds, test_update_leaves_others)
+{
+    zassert_ok(leds_write(LEDS_ALL));
+    zassert_ok(leds_update(BIT(LEDS_TEST_IDX), 0));
+    zassert_equal(leds_readback(), LEDS_ALL & ~BIT(LEDS_TEST_IDX));
+
+    zassert_ok(leds_update(BIT(LEDS_TEST_IDX), LEDS_ALL));
+    zassert_equal(leds_readback(), LEDS_ALL);
+}
+
+ZTEST_SUITE(leds, NULL, leds_setup, leds_before, NULL, NULL);
+
+K_THREAD_STACK_DEFINE(sequencer_stack, 1024);
+static struct k_thread sequencer_thread;
+static int sequencer_ret;
+
+static void sequencer_entry(void *p1, void *p2, void *p3)
+{
+    ARG_UNUSED(p1);
+    ARG_UNUSED(p2);
+    ARG_UNUSED(p3);
+
+    sequencer_ret = sequencer_run(&app_pattern, CONFIG_APP_PATTERN_REPEAT);
+}
+
+// Plays the app's pattern and checks the pins halfway through every frame,
+// well clear of both of its edges.
+ZTEST(sequencer, test_frames_reach_pins)
+{
+    // simulated time stands still until this thread sleeps, so the
+    // sequencer anchors its schedule at the same tick as `at`
+    int64_t at = k_uptime_ticks();
+
+    k_thread_create(&sequencer_thread, sequencer_stack, K_THREAD_STACK_SIZEOF(sequencer_stack),
+                    sequencer_entry, NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+    for (uint32_t r = 0; r < CONFIG_APP_PATTERN_REPEAT; r++) {
+        for (size_t i = 0; i < app_pattern.count; i++) {
+            const struct led_frame *frame = &app_pattern.frames[i];
+            int64_t length = k_ms_to_ticks_ceil64(frame->duration_ms);
+
+            k_sleep(K_TIMEOUT_ABS_TICKS(at + length / 2));
+            zassert_equal(leds_readback(), frame->mask, "frame %u of pass %u not on the pins",
+                          (unsigned int)i, r);
+            at += length;
+        }
+    }
+
+    zassert_ok(k_thread_join(&sequencer_thread, K_FOREVER));
+    zassert_ok(sequencer_ret);
+}
+
+ZTEST_SUITE(sequencer, NULL, leds_setup, leds_before, NULL, NULL);